@@ -12,7 +12,7 @@ extern const std::string sssp::arguments_csv_header(
     "edge_alg,edge_planar_probability,edge_uniform_probability,edge_layered_probability,edge_layered_count,edge_kronecker_initiator,edge_kronecker_k,"
     "cost_alg,"
     "graph_file,"
-    "alg,seed");
+    "alg,delta,rho,seed");
 // clang-format on
 
 namespace sssp { // thanks ADL!
@@ -84,6 +84,14 @@ std::string sssp::arguments_csv_values(const sssp::arguments& args) {
     out << na_if(graph_file, args.cost_gen.algorithm) << ",";
     out << na_if(!graph_file, boost::filesystem::path(args.graph_file).filename().string()) << ",";
     out << args.algorithms << ",";
+    out << na_if(std::find(args.algorithms.begin(), args.algorithms.end(), sssp_algorithm::delta_stepping) ==
+                     args.algorithms.end(),
+                 args.delta)
+        << ",";
+    out << na_if(std::find(args.algorithms.begin(), args.algorithms.end(), sssp_algorithm::radius_stepping) ==
+                     args.algorithms.end(),
+                 args.rho)
+        << ",";
     out << na_if(graph_file, args.seed);
 
     return out.str();
@@ -161,14 +169,51 @@ boost::optional<sssp::arguments> sssp::parse_arguments(int argc, const char* con
             "  - euclidean: \tall edges have their euclidean length as cost")
         ;
 
+    po::options_description order_opts("Node order (does not change the graph, but the memory layout)");
+    order_opts.add_options()
+        ("order,O", po::value(&args.order.algorithm)->default_value(args.order.algorithm),
+            "Set the order the nodes are renumbered in before running the algorithms. The output always uses the original order. Possible values:\n"
+            "  - none: \tkeep the order of generation or of the graph file\n"
+            "  - hilbert: \tsort the nodes along a Hilbert curve through their positions\n"
+            "  - bfs: \tbreadth first search from the start node\n"
+            "  - rcm: \treverse Cuthill-McKee")
+        ;
+
+    po::options_description type_opts("Graph storage (does not change the results as long as the precision suffices)");
+    type_opts.add_options()
+        ("node-type", po::value(&args.types.node)->default_value(args.types.node),
+            "Set the integer type used for node indices. Possible values:\n"
+            "  - uint32: \t32 bit, graphs must have less than 2^32 - 1 nodes\n"
+            "  - uint64: \t64 bit")
+        ("cost-type", po::value(&args.types.cost)->default_value(args.types.cost),
+            "Set the floating point type used for edge costs and distances. Possible values:\n"
+            "  - float32: \tsingle precision\n"
+            "  - float64: \tdouble precision")
+        ("compress-graph", po::value(&args.types.compressed)->default_value(args.types.compressed)->implicit_value(true),
+            "Store the neighbours of each node delta and varint encoded. Kronecker graphs need about three times less memory, four times less together with `--cost-type float32`.")
+        ;
+
     po::options_description all_opts("Single Source Shortest Path simulation tool. Global options");
     all_opts.add_options()
         ("help,h",
             "Show this help message.")
         ("graph-file,g", po::value(&args.graph_file)->default_value(args.graph_file),
-            "Load a graph from a textfile with the line-format `source destination cost`, with cost being optional. Position, edge and cost generation choices are ignored if this option is supplied.")
+            "Load a graph from a textfile with the line-format `source destination cost`, with cost being optional, or from a binary graph file created by sssp-convert. Position, edge and cost generation choices are ignored if this option is supplied.")
+        ("graph-format", po::value(&args.graph_file_format)->default_value(args.graph_file_format),
+            "Set the format of the graph file. Possible values:\n"
+            "  - guess: \tbinary graph files are detected, .gr files are read as DIMACS, .graph and .metis files as METIS and all others as edge lists\n"
+            "  - edge_list: \tlines of `source destination cost`\n"
+            "  - dimacs: \tDIMACS shortest path challenge format (`p sp` and `a` lines)\n"
+            "  - metis: \tMETIS graph format, each undirected edge becomes two directed edges\n"
+            "  - binary: \tbinary graph file created by sssp-convert")
+        ("graph-cache", po::value(&args.graph_cache)->default_value(args.graph_cache),
+            "Store generated graphs in this directory and load them from there if the same graph is generated again. Concurrent runs can share the directory.")
         ("seed,s", po::value(&args.seed)->default_value(args.seed),
             "Set the seed.")
+        ("threads", po::value(&args.threads)->default_value(args.threads),
+            "Set the number of threads relaxing the nodes of a phase and asking the criteria for them. Does not change the results.")
+        ("lazy-queues", po::value(&args.lazy_queues)->default_value(args.lazy_queues)->implicit_value(true),
+            "Keep the thresholds of traff, crauser_in_dyn and crauser_out_dyn in queues that invalidate entries lazily instead of moving them, and print how many heap operations that saved. Does not change the results.")
         ("algorithm,a", po::value<std::vector<sssp_algorithm>>(&args.algorithms)->composing()->default_value(args.algorithms),
             "Set the SSSP algorithm. This argument can be passed multiple times to combine criteria. Possible values:\n"
             "  - dijkstra: \tDijkstra's algorithm\n"
@@ -178,7 +223,13 @@ boost::optional<sssp::arguments> sssp::parse_arguments(int argc, const char* con
             "  - crauser_out_dyn: \tCrauser et al. using the OUT criteria only looking at nodes not settled.\n"
             "  - oracle: \tUses an oracle to relax all nodes that can be safely relaxed in any given phase.\n"
             "  - heuristic: \tUses a heuristic to decide which nodes can be relaxed. The graph has to be euclidean.\n"
-            "  - traff: \tLike Crauser et al. IN dynamic critiera but with an additional static lookahead.")
+            "  - traff: \tLike Crauser et al. IN dynamic critiera but with an additional static lookahead.\n"
+            "  - delta_stepping: \tMeyer and Sanders' delta-stepping with the bucket width `--delta`. It is label correcting, thus it relaxes some nodes more than once and cannot be combined with other algorithms.\n"
+            "  - radius_stepping: \tBlelloch et al. radius-stepping with the radii given by `--rho`. It is label correcting like delta_stepping and cannot be combined with other algorithms either.")
+        ("delta", po::value(&args.delta)->default_value(args.delta),
+            "Set the bucket width of `-a delta_stepping`. 0 chooses the maximal edge cost divided by the average out-degree.")
+        ("rho", po::value(&args.rho)->default_value(args.rho),
+            "Set the radius of each node for `-a radius_stepping` to the distance to its rho-th nearest node. The nearest nodes are searched with `--threads` threads.")
         ;
 #ifndef DISABLE_CAIRO
 	all_opts.add(img_opts);
@@ -186,6 +237,8 @@ boost::optional<sssp::arguments> sssp::parse_arguments(int argc, const char* con
     all_opts.add(pos_opts);
     all_opts.add(edge_opts);
     all_opts.add(cost_opts);
+    all_opts.add(order_opts);
+    all_opts.add(type_opts);
 
     // clang-format on
 
@@ -215,9 +268,26 @@ boost::optional<sssp::arguments> sssp::parse_arguments(int argc, const char* con
         return {};
     }
 
+    if (args.order.algorithm == order_algorithm::hilbert &&
+        (!args.graph_file.empty() || args.edge_gen.algorithm == edge_algorithm::kronecker)) {
+        if (error_output) {
+            *error_output << "`-O hilbert` needs node positions and cannot be used with `-g` or `-E kronecker`.\n";
+        }
+        return {};
+    }
+
     std::set<sssp_algorithm> algorithms_set(args.algorithms.begin(), args.algorithms.end());
     args.algorithms = std::vector<sssp_algorithm>(algorithms_set.begin(), algorithms_set.end());
 
+    for (sssp_algorithm label_correcting : {sssp_algorithm::delta_stepping, sssp_algorithm::radius_stepping}) {
+        if (algorithms_set.count(label_correcting) > 0 && algorithms_set.size() > 1) {
+            if (error_output) {
+                *error_output << "`-a " << label_correcting << "` cannot be combined with other algorithms.\n";
+            }
+            return {};
+        }
+    }
+
     args.edge_gen.kronecker.initiator.clear();
     std::vector<std::string> split_kronecker_initiator;
     boost::split(split_kronecker_initiator,
@@ -12,6 +12,10 @@ namespace sssp {
 STRINGY_ENUM(position_algorithm, poisson, uniform)
 STRINGY_ENUM(edge_algorithm, planar, uniform, layered, kronecker)
 STRINGY_ENUM(cost_algorithm, uniform, one, euclidean)
+STRINGY_ENUM(graph_format, guess, edge_list, dimacs, metis, binary)
+STRINGY_ENUM(order_algorithm, none, hilbert, bfs, rcm)
+STRINGY_ENUM(node_index_type, uint32, uint64)
+STRINGY_ENUM(edge_cost_type, float32, float64)
 STRINGY_ENUM(sssp_algorithm,
              dijkstra,
              crauser_in,
@@ -22,7 +26,9 @@ STRINGY_ENUM(sssp_algorithm,
              heuristic,
              traff,
              paper_in,
-             paper_out)
+             paper_out,
+             delta_stepping,
+             radius_stepping)
 
 std::ostream& operator<<(std::ostream& out, const std::vector<sssp_algorithm>& algorithms);
 std::ostream& operator<<(std::ostream& out, const std::vector<double>& vector);
@@ -81,6 +87,11 @@ template <typename T> T return_zero() {
 }
 using from_zero_to_one_double = validated<double, is_from_zero_to_one<double>, return_zero<double>>;
 
+template <typename T> bool is_non_negative(const T& value) {
+    return value >= T(0);
+}
+using non_negative_double = validated<double, is_non_negative<double>, return_zero<double>>;
+
 struct arguments {
     struct position_gen {
         position_algorithm algorithm = position_algorithm::poisson;
@@ -115,8 +126,26 @@ struct arguments {
         cost_algorithm algorithm = cost_algorithm::uniform;
     } cost_gen;
 
+    struct order {
+        order_algorithm algorithm = order_algorithm::none;
+    } order;
+
+    struct types {
+        node_index_type node = node_index_type::uint64;
+        edge_cost_type cost = edge_cost_type::float64;
+        bool compressed = false;
+    } types;
+
     std::string graph_file = "";
+    graph_format graph_file_format = graph_format::guess;
+    std::string graph_cache = "";
     int seed = 42;
+    positive_int threads = 1;
+    bool lazy_queues = false;
+    // The bucket width of delta_stepping, 0 chooses it from the graph.
+    non_negative_double delta = 0;
+    // The number of nearest nodes that determine the radius of a node in radius_stepping.
+    positive_int rho = 16;
     std::vector<sssp_algorithm> algorithms = {sssp_algorithm::dijkstra};
 
 #ifndef DISABLE_CAIRO
@@ -1,144 +1,219 @@
 #include "crit_crauser.hpp"
 #include <boost/assert.hpp>
 
-sssp::crauser_in::crauser_in(const sssp::graph* graph, size_t start_node, bool dynamic)
-    : criteria(graph, start_node), m_node_info(graph->make_node_map([&](size_t n) { return node_info(*graph, n); })),
-      m_dynamic(dynamic) {}
-
-void sssp::crauser_in::relaxable_nodes(todo_output& output) const {
-    if (!m_distance_queue.empty()) {
-        double m = m_distance_queue.top()->tentative_distance;
-
-        auto iter = m_threshold_queue.ordered_begin();
-        auto end = m_threshold_queue.ordered_end();
-        while (iter != end && (*iter)->threshold() <= m) {
-            output.emplace((*iter)->index);
-            ++iter;
-        }
+template <typename Node, typename Cost, typename ThresholdQueue>
+sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::basic_crauser_in(const graph_type* graph,
+                                                                     size_t start_node,
+                                                                     bool dynamic)
+    : basic_criteria<Node, Cost>(graph, start_node),
+      m_node_info(graph->make_node_map([index = &graph->index()](size_t n) { return node_info(index->incoming(n)); })),
+      m_dynamic(dynamic), m_threshold_queue(graph->node_count()), m_touched(graph->node_count()) {}
+
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        Cost m = this->fringe().top_key();
+        m_threshold_queue.for_each_unordered_up_to(m, [&](Node node) { output.emplace(node); });
     }
 }
 
-void sssp::crauser_in::changed_predecessor(size_t node, size_t predecessor, double distance) {
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::changed_predecessor(Node node,
+                                                                             Node predecessor,
+                                                                             Cost distance) {
     node_info& info = m_node_info[node];
     info.tentative_distance = distance;
-    if (info.distance_queue_handle == distance_queue::handle_type()) {
-        info.distance_queue_handle = m_distance_queue.push(&info);
-        info.threshold_queue_handle = m_threshold_queue.push(&info);
+    if (!m_threshold_queue.contains(node)) {
+        m_threshold_queue.push(node, info.threshold());
     } else {
-        m_distance_queue.update(info.distance_queue_handle);
-        m_threshold_queue.update(info.threshold_queue_handle);
+        m_threshold_queue.update(node, info.threshold());
     }
 }
 
-void sssp::crauser_in::relaxed_node(size_t node) {
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::relaxed_node(Node node) {
     node_info& info = m_node_info[node];
     info.settled = true;
-    m_distance_queue.erase(info.distance_queue_handle);
-    m_threshold_queue.erase(info.threshold_queue_handle);
+    m_threshold_queue.erase(node);
 
     if (m_dynamic) {
-        for (const auto& outgoing : graph().outgoing_edges(node)) {
+        for (const auto& outgoing : this->graph().outgoing_edges(node)) {
             node_info& dest = m_node_info[outgoing.destination];
             if (!dest.settled) {
-                while (!dest.incoming.empty() && m_node_info[dest.incoming.back().source].settled) {
-                    dest.incoming.pop_back();
+                while (!dest.incoming.empty() && m_node_info[dest.incoming.front().node].settled) {
+                    dest.incoming.pop_front();
                 }
-                if (dest.threshold_queue_handle != threshold_queue::handle_type()) {
-                    m_threshold_queue.update(dest.threshold_queue_handle);
+                if (m_threshold_queue.contains(outgoing.destination)) {
+                    m_threshold_queue.update(outgoing.destination, dest.threshold());
                 }
             }
         }
     }
 }
 
-bool sssp::crauser_in::node_info_compare_distance::operator()(const node_info* a, const node_info* b) const {
-    return a->tentative_distance > b->tentative_distance;
-}
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::relaxed_phase(const std::vector<predecessor_change>& changes,
+                                                                       const std::vector<Node>& relaxed) {
+    // Settle all relaxed nodes first, then their incoming edges can be dropped at once.
+    for (Node node : relaxed) {
+        m_node_info[node].settled = true;
+        m_threshold_queue.erase(node);
+    }
+    if (m_dynamic) {
+        for (Node node : relaxed) {
+            for (const auto& outgoing : this->graph().outgoing_edges(node)) {
+                node_info& dest = m_node_info[outgoing.destination];
+                if (!dest.settled) {
+                    while (!dest.incoming.empty() && m_node_info[dest.incoming.front().node].settled) {
+                        dest.incoming.pop_front();
+                    }
+                    m_touched.insert(outgoing.destination);
+                }
+            }
+        }
+    }
 
-bool sssp::crauser_in::node_info_compare_threshold::operator()(const node_info* a, const node_info* b) const {
-    return a->threshold() > b->threshold();
-}
+    for (const predecessor_change& change : changes) {
+        node_info& info = m_node_info[change.node];
+        info.tentative_distance = change.distance;
+        if (!m_threshold_queue.contains(change.node)) {
+            m_threshold_queue.push(change.node, info.threshold());
+        } else {
+            m_touched.insert(change.node);
+        }
+    }
 
-sssp::crauser_in::node_info::node_info(const sssp::graph& g, size_t index)
-    : index(index), incoming(g.incoming_edges(index).begin(), g.incoming_edges(index).end()) {
-    std::sort(incoming.begin(), incoming.end(), [](const auto& a, const auto& b) { return a.cost > b.cost; });
+    for (Node node : m_touched) {
+        if (m_threshold_queue.contains(node)) {
+            m_threshold_queue.update(node, m_node_info[node].threshold());
+        }
+    }
+    m_touched.clear();
 }
 
-double sssp::crauser_in::node_info::threshold() const {
+template <typename Node, typename Cost, typename ThresholdQueue>
+Cost sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::node_info::threshold() const {
     if (incoming.empty()) {
         return -INFINITY;
     } else {
-        return tentative_distance - incoming.back().cost;
+        return tentative_distance - incoming.front().cost;
     }
 }
 
-sssp::crauser_out::crauser_out(const sssp::graph* graph, size_t start_node, bool dynamic)
-    : criteria(graph, start_node), m_node_info(graph->make_node_map([&](size_t n) { return node_info(*graph, n); })),
-      m_dynamic(dynamic) {}
-
-void sssp::crauser_out::relaxable_nodes(todo_output& output) const {
-    if (!m_distance_queue.empty()) {
-        double l = m_threshold_queue.top()->threshold();
-
-        auto iter = m_distance_queue.ordered_begin();
-        auto end = m_distance_queue.ordered_end();
-        while (iter != end && (*iter)->tentative_distance <= l) {
-            output.emplace((*iter)->index);
-            ++iter;
-        }
+template <typename Node, typename Cost, typename ThresholdQueue>
+sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::basic_crauser_out(const graph_type* graph,
+                                                                       size_t start_node,
+                                                                       bool dynamic)
+    : basic_criteria<Node, Cost>(graph, start_node),
+      m_node_info(graph->make_node_map([index = &graph->index()](size_t n) { return node_info(index->outgoing(n)); })),
+      m_dynamic(dynamic), m_threshold_queue(graph->node_count()), m_touched(graph->node_count()) {}
+
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        Cost l = m_threshold_queue.top_key();
+        this->fringe().for_each_unordered_up_to(l, [&](Node node) { output.emplace(node); });
     }
 }
 
-void sssp::crauser_out::changed_predecessor(size_t node, size_t predecessor, double distance) {
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::changed_predecessor(Node node,
+                                                                              Node predecessor,
+                                                                              Cost distance) {
     node_info& info = m_node_info[node];
     info.tentative_distance = distance;
-    if (info.distance_queue_handle == distance_queue::handle_type()) {
-        info.distance_queue_handle = m_distance_queue.push(&info);
-        info.threshold_queue_handle = m_threshold_queue.push(&info);
+    if (!m_threshold_queue.contains(node)) {
+        m_threshold_queue.push(node, info.threshold());
     } else {
-        m_distance_queue.update(info.distance_queue_handle);
-        m_threshold_queue.update(info.threshold_queue_handle);
+        m_threshold_queue.update(node, info.threshold());
     }
 }
 
-void sssp::crauser_out::relaxed_node(size_t node) {
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::relaxed_node(Node node) {
     node_info& info = m_node_info[node];
     info.settled = true;
 
-    m_distance_queue.erase(info.distance_queue_handle);
-    m_threshold_queue.erase(info.threshold_queue_handle);
+    m_threshold_queue.erase(node);
     if (m_dynamic) {
-        for (const auto& edge : graph().incoming_edges(node)) {
+        for (const auto& edge : this->graph().incoming_edges(node)) {
             node_info& source = m_node_info[edge.source];
             if (!source.settled) {
-                while (!source.outgoing.empty() && m_node_info[source.outgoing.back().destination].settled) {
-                    source.outgoing.pop_back();
+                while (!source.outgoing.empty() && m_node_info[source.outgoing.front().node].settled) {
+                    source.outgoing.pop_front();
                 }
-                if (source.threshold_queue_handle != threshold_queue::handle_type()) {
-                    m_threshold_queue.update(source.threshold_queue_handle);
+                if (m_threshold_queue.contains(edge.source)) {
+                    m_threshold_queue.update(edge.source, source.threshold());
                 }
             }
         }
     }
 }
 
-bool sssp::crauser_out::node_info_compare_distance::operator()(const node_info* a, const node_info* b) const {
-    return a->tentative_distance > b->tentative_distance;
-}
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::relaxed_phase(const std::vector<predecessor_change>& changes,
+                                                                        const std::vector<Node>& relaxed) {
+    // Settle all relaxed nodes first, then their outgoing edges can be dropped at once.
+    for (Node node : relaxed) {
+        m_node_info[node].settled = true;
+        m_threshold_queue.erase(node);
+    }
+    if (m_dynamic) {
+        for (Node node : relaxed) {
+            for (const auto& edge : this->graph().incoming_edges(node)) {
+                node_info& source = m_node_info[edge.source];
+                if (!source.settled) {
+                    while (!source.outgoing.empty() && m_node_info[source.outgoing.front().node].settled) {
+                        source.outgoing.pop_front();
+                    }
+                    m_touched.insert(edge.source);
+                }
+            }
+        }
+    }
 
-bool sssp::crauser_out::node_info_compare_threshold::operator()(const node_info* a, const node_info* b) const {
-    return a->threshold() > b->threshold();
-}
+    for (const predecessor_change& change : changes) {
+        node_info& info = m_node_info[change.node];
+        info.tentative_distance = change.distance;
+        if (!m_threshold_queue.contains(change.node)) {
+            m_threshold_queue.push(change.node, info.threshold());
+        } else {
+            m_touched.insert(change.node);
+        }
+    }
 
-sssp::crauser_out::node_info::node_info(const sssp::graph& g, size_t index)
-    : index(index), outgoing(g.outgoing_edges(index).begin(), g.outgoing_edges(index).end()) {
-    std::sort(outgoing.begin(), outgoing.end(), [](const auto& a, const auto& b) { return a.cost > b.cost; });
+    for (Node node : m_touched) {
+        if (m_threshold_queue.contains(node)) {
+            m_threshold_queue.update(node, m_node_info[node].threshold());
+        }
+    }
+    m_touched.clear();
 }
 
-double sssp::crauser_out::node_info::threshold() const {
+template <typename Node, typename Cost, typename ThresholdQueue>
+Cost sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::node_info::threshold() const {
     if (outgoing.empty()) {
         return INFINITY;
     } else {
-        return tentative_distance + outgoing.back().cost;
+        return tentative_distance + outgoing.front().cost;
     }
 }
+
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_in<Node, Cost, ThresholdQueue>::print_counters(std::ostream& out) const {
+    print_queue_counters(
+        out, m_dynamic ? "crauser_in_dyn threshold queue" : "crauser_in threshold queue", m_threshold_queue);
+}
+
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_crauser_out<Node, Cost, ThresholdQueue>::print_counters(std::ostream& out) const {
+    print_queue_counters(
+        out, m_dynamic ? "crauser_out_dyn threshold queue" : "crauser_out threshold queue", m_threshold_queue);
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template class sssp::basic_crauser_in<NODE, COST>;                                                                 \
+    template class sssp::basic_crauser_out<NODE, COST>;                                                                \
+    template class sssp::basic_crauser_in<NODE, COST, sssp::lazy_priority_queue<COST, NODE>>;                          \
+    template class sssp::basic_crauser_out<NODE, COST, sssp::lazy_priority_queue<COST, NODE>>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
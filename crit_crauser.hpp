@@ -2,96 +2,108 @@
 #include "criteria.hpp"
 #include "dijkstra.hpp"
 #include "graph.hpp"
+#include "graph_index.hpp"
+#include "priority_queue.hpp"
 #include "stringy_enum.hpp"
-#include <boost/heap/pairing_heap.hpp>
-#include <unordered_set>
+#include <vector>
 
 namespace sssp {
 
 // Implements Crauser's IN criteria. Additionally instead of using the minimal edges,
-// with dynamic=true, one can use the minimal non-settled edge.
-class crauser_in : public criteria {
+// with dynamic=true, one can use the minimal non-settled edge. Dynamic thresholds change often,
+// a lazy_priority_queue as ThresholdQueue avoids moving entries whose key stays the same.
+template <typename Node, typename Cost, typename ThresholdQueue = priority_queue<Cost, Node>>
+class basic_crauser_in : public basic_criteria<Node, Cost> {
   public:
-    crauser_in(const sssp::graph* graph, size_t start_node, bool dynamic);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using typename basic_criteria<Node, Cost>::predecessor_change;
+
+    basic_crauser_in(const graph_type* graph, size_t start_node, bool dynamic);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
+    // Updates each queue entry at most once per phase instead of once per notification.
+    virtual bool batches_notifications() const override { return true; }
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes,
+                               const std::vector<Node>& relaxed) override;
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return true; }
+    virtual void print_counters(std::ostream& out) const override;
     bool dynamic() const { return m_dynamic; }
 
   private:
-    struct node_info;
-    struct node_info_compare_distance {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-    // threshold(n) = tentative(n) - min{ cost of incmoing edges (not settled if dynamic) }
-    // Called "i" in the paper.
-    struct node_info_compare_threshold {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-
-    using distance_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_distance>>;
-    using threshold_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_threshold>>;
+    using neighbour_range = typename basic_graph_index<Node, Cost>::neighbour_range;
 
     struct node_info {
-        node_info(const sssp::graph& g, size_t index);
-        size_t index;
-        std::vector<edge_info> incoming;
-        double tentative_distance = INFINITY;
+        explicit node_info(neighbour_range incoming) : incoming(incoming) {}
+        // The incoming edges by ascending cost, without the settled ones at the front if dynamic.
+        neighbour_range incoming;
+        Cost tentative_distance = INFINITY;
         bool settled = false;
-        distance_queue::handle_type distance_queue_handle;
-        threshold_queue::handle_type threshold_queue_handle;
 
-        double threshold() const;
+        // threshold(n) = tentative(n) - min{ cost of incmoing edges (not settled if dynamic) }
+        // Called "i" in the paper.
+        Cost threshold() const;
     };
 
     bool m_dynamic;
     node_map<node_info> m_node_info;
-    distance_queue m_distance_queue;
-    threshold_queue m_threshold_queue;
+    // The fringe nodes by threshold, the engine keeps them by tentative distance.
+    ThresholdQueue m_threshold_queue;
+    // The nodes whose threshold has to be updated at the end of relaxed_phase.
+    basic_node_set<Node> m_touched;
 };
 
 // Implements Crauser's OUT criteria. Additionally instead of using the minimal edges,
-// with dynamic=true, one can use the minimal non-settled edge.
-class crauser_out : public criteria {
+// with dynamic=true, one can use the minimal non-settled edge. See basic_crauser_in for the
+// ThresholdQueue.
+template <typename Node, typename Cost, typename ThresholdQueue = priority_queue<Cost, Node>>
+class basic_crauser_out : public basic_criteria<Node, Cost> {
   public:
-    crauser_out(const sssp::graph* graph, size_t start_node, bool dynamic);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using typename basic_criteria<Node, Cost>::predecessor_change;
+
+    basic_crauser_out(const graph_type* graph, size_t start_node, bool dynamic);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
+    // Updates each queue entry at most once per phase instead of once per notification.
+    virtual bool batches_notifications() const override { return true; }
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes,
+                               const std::vector<Node>& relaxed) override;
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return true; }
+    virtual void print_counters(std::ostream& out) const override;
     bool dynamic() const { return m_dynamic; }
 
   private:
-    struct node_info;
-    struct node_info_compare_distance {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-    // threshold(n) = tentative(n) + min{ outgoing edge (not settled if dynamic) }
-    // Called "L" in the paper (to be exact this are the values of all nodes, not the final L)
-    struct node_info_compare_threshold {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-
-    using distance_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_distance>>;
-    using threshold_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_threshold>>;
+    using neighbour_range = typename basic_graph_index<Node, Cost>::neighbour_range;
 
     struct node_info {
-        node_info(const sssp::graph& g, size_t index);
-        size_t index;
-        std::vector<edge_info> outgoing;
-        double tentative_distance = INFINITY;
+        explicit node_info(neighbour_range outgoing) : outgoing(outgoing) {}
+        // The outgoing edges by ascending cost, without the settled ones at the front if dynamic.
+        neighbour_range outgoing;
+        Cost tentative_distance = INFINITY;
         bool settled = false;
-        distance_queue::handle_type distance_queue_handle;
-        threshold_queue::handle_type threshold_queue_handle;
 
-        double threshold() const;
+        // threshold(n) = tentative(n) + min{ outgoing edge (not settled if dynamic) }
+        // Called "L" in the paper (to be exact this are the values of all nodes, not the final L)
+        Cost threshold() const;
     };
 
     bool m_dynamic;
     node_map<node_info> m_node_info;
-    distance_queue m_distance_queue;
-    threshold_queue m_threshold_queue;
+    // The fringe nodes by threshold, the engine keeps them by tentative distance.
+    ThresholdQueue m_threshold_queue;
+    // The nodes whose threshold has to be updated at the end of relaxed_phase.
+    basic_node_set<Node> m_touched;
 };
 
-} // namespace sssp
\ No newline at end of file
+using crauser_in = basic_crauser_in<size_t, double>;
+using crauser_out = basic_crauser_out<size_t, double>;
+using lazy_crauser_in = basic_crauser_in<size_t, double, lazy_priority_queue<double, size_t>>;
+using lazy_crauser_out = basic_crauser_out<size_t, double, lazy_priority_queue<double, size_t>>;
+
+} // namespace sssp
@@ -1,27 +1,17 @@
 #include "crit_dijkstra.hpp"
 
-sssp::smallest_tentative_distance::smallest_tentative_distance(const sssp::graph* graph, size_t start_node)
-    : criteria(graph, start_node), m_node_info(graph->make_node_map([](size_t i) { return node_info(i); })) {}
+template <typename Node, typename Cost>
+sssp::basic_smallest_tentative_distance<Node, Cost>::basic_smallest_tentative_distance(const graph_type* graph,
+                                                                                       size_t start_node)
+    : basic_criteria<Node, Cost>(graph, start_node) {}
 
-void sssp::smallest_tentative_distance::relaxable_nodes(todo_output& output) const {
-    if (!m_queue.empty()) {
-        output.emplace(m_queue.top()->index);
+template <typename Node, typename Cost>
+void sssp::basic_smallest_tentative_distance<Node, Cost>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        // Ties are broken by the node index, so the result does not depend on the order of the edges.
+        output.emplace(this->fringe().top());
     }
 }
 
-void sssp::smallest_tentative_distance::changed_predecessor(size_t node, size_t predecessor, double distance) {
-    m_node_info[node].tentative_distance = distance;
-    if (m_node_info[node].queue_handle == queue::handle_type()) {
-        m_node_info[node].queue_handle = m_queue.push(&m_node_info[node]);
-    } else {
-        m_queue.update(m_node_info[node].queue_handle);
-    }
-}
-
-void sssp::smallest_tentative_distance::relaxed_node(size_t node) {
-    m_queue.erase(m_node_info[node].queue_handle);
-}
-
-bool sssp::smallest_tentative_distance::node_info_compare::operator()(const node_info* a, const node_info* b) const {
-    return a->tentative_distance > b->tentative_distance;
-}
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_smallest_tentative_distance<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -1,35 +1,22 @@
 #pragma once
 #include "criteria.hpp"
-#include <boost/heap/pairing_heap.hpp>
 
 namespace sssp {
 
-class smallest_tentative_distance : public criteria {
+// Relaxes the fringe node with the smallest tentative distance, which is Dijkstra's algorithm.
+template <typename Node, typename Cost> class basic_smallest_tentative_distance : public basic_criteria<Node, Cost> {
   public:
-    smallest_tentative_distance(const sssp::graph* graph, size_t start_node);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+
+    basic_smallest_tentative_distance(const graph_type* graph, size_t start_node);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override {}
+    virtual void relaxed_node(Node node) override {}
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return true; }
-
-  private:
-    struct node_info;
-
-    struct node_info_compare {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-
-    using queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare>>;
-
-    struct node_info {
-        node_info(size_t index) : index(index) {}
-        size_t index;
-        double tentative_distance = INFINITY;
-        queue::handle_type queue_handle;
-    };
-
-    node_map<node_info> m_node_info;
-    queue m_queue;
 };
 
-} // namespace sssp
\ No newline at end of file
+using smallest_tentative_distance = basic_smallest_tentative_distance<size_t, double>;
+
+} // namespace sssp
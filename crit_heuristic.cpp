@@ -1,57 +1,82 @@
 #include "crit_heuristic.hpp"
+#include "parallel.hpp"
+#include <algorithm>
 #include <boost/assert.hpp>
-#include <boost/heap/pairing_heap.hpp>
-#include <cfloat>
-#include <unordered_set>
-
-sssp::heuristic::heuristic(const sssp::graph* graph, size_t start_node, const relaxation_heuristic& heuristic)
-    : criteria(graph, start_node), m_heuristic(heuristic),
-      m_node_info(graph->make_node_map([&](size_t node) { return node_info(*graph, heuristic, node); })) {
-
-    node_info& start = m_node_info[start_node];
-    if (start.unsettled_predecessors.empty() ||
-        start.tentative_distance <= start.unsettled_predecessors.back().estimated_distance) {
-        m_safe_to_relax.insert(start_node);
+
+namespace {
+
+// Returns est(p) + cost(p, n) for the incoming edges (p, n) of each node n, sorted by that cost.
+template <typename Node, typename Cost, typename Neighbour>
+std::shared_ptr<const std::vector<Neighbour>> estimated_predecessors(const sssp::basic_graph<Node, Cost>& graph,
+                                                                     const sssp::node_map<Cost>& estimates) {
+    BOOST_ASSERT(estimates.size() == graph.node_count());
+    const size_t* offsets = graph.raw_arrays().incoming_offsets;
+    auto predecessors = std::make_shared<std::vector<Neighbour>>(graph.edge_count());
+    sssp::parallel_for(graph.node_count(), sssp::default_thread_count(), [&](size_t node) {
+        Neighbour* begin = predecessors->data() + offsets[node];
+        Neighbour* out = begin;
+        for (const auto& edge : graph.incoming_edges(static_cast<Node>(node))) {
+            *out++ = Neighbour{edge.source, estimates[edge.source] + edge.cost};
+        }
+        std::sort(begin, out, [](const Neighbour& a, const Neighbour& b) { return a.cost < b.cost; });
+    });
+    return predecessors;
+}
+
+} // namespace
+
+template <typename Node, typename Cost>
+sssp::basic_heuristic<Node, Cost>::basic_heuristic(const graph_type* graph,
+                                                   size_t start_node,
+                                                   const heuristic_type& heuristic)
+    : basic_heuristic(
+          graph, start_node, graph->make_node_map([&](size_t node) { return heuristic(static_cast<Node>(node)); })) {}
+
+template <typename Node, typename Cost>
+sssp::basic_heuristic<Node, Cost>::basic_heuristic(const graph_type* graph,
+                                                   size_t start_node,
+                                                   const node_map<Cost>& estimates)
+    : basic_criteria<Node, Cost>(graph, start_node),
+      m_predecessors(estimated_predecessors<Node, Cost, neighbour>(*graph, estimates)),
+      m_node_info(graph->make_node_map([&](size_t node) {
+          const size_t* offsets = graph->raw_arrays().incoming_offsets;
+          const neighbour* predecessors = m_predecessors->data();
+          return node_info(neighbour_range(predecessors + offsets[node], predecessors + offsets[node + 1]));
+      })),
+      m_safe_to_relax(graph->node_count()) {
+
+    if (m_node_info[this->start_node()].safe_to_relax()) {
+        m_safe_to_relax.insert(this->start_node());
     }
 }
 
-void sssp::heuristic::relaxable_nodes(todo_output& output) const {
+template <typename Node, typename Cost>
+void sssp::basic_heuristic<Node, Cost>::relaxable_nodes(todo_output& output) const {
     output.insert(m_safe_to_relax.begin(), m_safe_to_relax.end());
 }
 
-void sssp::heuristic::changed_predecessor(size_t node, size_t predecessor, double distance) {
+template <typename Node, typename Cost>
+void sssp::basic_heuristic<Node, Cost>::changed_predecessor(Node node, Node predecessor, Cost distance) {
     BOOST_ASSERT(!m_node_info[node].settled);
     m_node_info[node].tentative_distance = distance;
 }
 
-void sssp::heuristic::relaxed_node(size_t node) {
+template <typename Node, typename Cost>
+void sssp::basic_heuristic<Node, Cost>::relaxed_node(Node node) {
     m_node_info[node].settled = true;
+    m_safe_to_relax.erase(node);
 
-    auto iter = m_safe_to_relax.find(node);
-    if (iter != m_safe_to_relax.end()) {
-        m_safe_to_relax.erase(iter);
-    }
-
-    for (const auto& outgoing_edge : graph().outgoing_edges(node)) {
+    for (const auto& outgoing_edge : this->graph().outgoing_edges(node)) {
         node_info& successor = m_node_info[outgoing_edge.destination];
         while (!successor.unsettled_predecessors.empty() &&
-               m_node_info[successor.unsettled_predecessors.back().index].settled) {
-            successor.unsettled_predecessors.pop_back();
+               m_node_info[successor.unsettled_predecessors.front().node].settled) {
+            successor.unsettled_predecessors.pop_front();
         }
-        if (!successor.settled &&
-            (successor.unsettled_predecessors.empty() ||
-             successor.tentative_distance <= successor.unsettled_predecessors.back().estimated_distance)) {
-            m_safe_to_relax.insert(successor.index);
+        if (!successor.settled && successor.safe_to_relax()) {
+            m_safe_to_relax.insert(outgoing_edge.destination);
         }
     }
 }
 
-sssp::heuristic::node_info::node_info(const sssp::graph& graph, const relaxation_heuristic& h, size_t index)
-    : index(index) {
-    for (const auto& incoming_edge : graph.incoming_edges(index)) {
-        unsettled_predecessors.emplace_back(incoming_edge.source, h(incoming_edge.source) + incoming_edge.cost);
-    }
-    std::sort(unsettled_predecessors.begin(), unsettled_predecessors.end(), [](const auto& a, const auto& b) {
-        return a.estimated_distance > b.estimated_distance;
-    });
-}
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_heuristic<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
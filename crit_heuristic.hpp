@@ -1,41 +1,59 @@
 #pragma once
 #include "criteria.hpp"
-#include <boost/heap/pairing_heap.hpp>
+#include "graph.hpp"
+#include "graph_index.hpp"
+#include "node_set.hpp"
 #include <functional>
-#include <unordered_set>
+#include <memory>
+#include <vector>
 
 namespace sssp {
 
-using relaxation_heuristic = std::function<double(size_t node)>;
+template <typename Node, typename Cost> using basic_relaxation_heuristic = std::function<Cost(Node node)>;
+using relaxation_heuristic = basic_relaxation_heuristic<size_t, double>;
 
-// Uses a heuristic to find nodes to relax.
-// The heuristic has to *underestimate* the real cost, i.e., est_fn(node) <= distance(start, node).
-class heuristic : public criteria {
+// Uses a heuristic to find nodes to relax: A node is safe to relax once its tentative distance is
+// not greater than est(p) + cost(p, node) for all its unsettled predecessors p.
+// The heuristic has to *underestimate* the real cost, i.e., est(node) <= distance(start, node).
+template <typename Node, typename Cost> class basic_heuristic : public basic_criteria<Node, Cost> {
   public:
-    heuristic(const sssp::graph* graph, size_t start_node, const relaxation_heuristic& heuristic);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using heuristic_type = basic_relaxation_heuristic<Node, Cost>;
+
+    // Calls the heuristic once for each node.
+    basic_heuristic(const graph_type* graph, size_t start_node, const heuristic_type& heuristic);
+    // Uses the precomputed estimate of each node.
+    basic_heuristic(const graph_type* graph, size_t start_node, const node_map<Cost>& estimates);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
     virtual bool is_complete() const override { return false; }
 
   private:
-    struct pred_info {
-        pred_info(size_t index, double est_distance) : index(index), estimated_distance(est_distance) {}
-        size_t index;
-        double estimated_distance;
-    };
+    using neighbour = typename basic_graph_index<Node, Cost>::neighbour;
+    using neighbour_range = typename basic_graph_index<Node, Cost>::neighbour_range;
 
     struct node_info {
-        node_info(const sssp::graph& graph, const relaxation_heuristic& h, size_t index);
-        size_t index;
-        std::vector<pred_info> unsettled_predecessors;
-        double tentative_distance = INFINITY;
+        explicit node_info(neighbour_range unsettled_predecessors) : unsettled_predecessors(unsettled_predecessors) {}
+        // The predecessors p with est(p) + cost(p, node) by ascending cost, without the settled
+        // ones at the front.
+        neighbour_range unsettled_predecessors;
+        Cost tentative_distance = INFINITY;
         bool settled = false;
+
+        bool safe_to_relax() const {
+            return unsettled_predecessors.empty() || tentative_distance <= unsettled_predecessors.front().cost;
+        }
     };
 
-    relaxation_heuristic m_heuristic;
-    std::unordered_set<size_t, std::hash<size_t>, std::equal_to<size_t>> m_safe_to_relax;
+    // The estimated predecessors of all nodes, in the order of the incoming edges of the graph.
+    // Shared by copies of the criteria, which point into it.
+    std::shared_ptr<const std::vector<neighbour>> m_predecessors;
     node_map<node_info> m_node_info;
+    basic_erasable_node_set<Node> m_safe_to_relax;
 };
 
-} // namespace sssp
\ No newline at end of file
+using heuristic = basic_heuristic<size_t, double>;
+
+} // namespace sssp
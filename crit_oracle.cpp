@@ -1,26 +1,30 @@
 #include "crit_oracle.hpp"
-#include "crit_dijkstra.hpp"
-#include <cfloat>
+#include <limits>
 
-sssp::oracle::oracle(const sssp::graph* graph, size_t start_node) : criteria(graph, start_node) {
-    boost::base_collection<criteria> cs;
-    cs.insert(smallest_tentative_distance(graph, start_node));
-    m_result = dijkstra(*graph, start_node, cs);
-    m_fringe.reserve(m_result.size());
+template <typename Node, typename Cost>
+sssp::basic_oracle<Node, Cost>::basic_oracle(const graph_type* graph, size_t start_node)
+    : basic_criteria<Node, Cost>(graph, start_node), m_distances(&graph->reference_distances(start_node)),
+      m_ready(graph->node_count()) {}
+
+template <typename Node, typename Cost>
+void sssp::basic_oracle<Node, Cost>::relaxable_nodes(todo_output& output) const {
+    output.insert(m_ready.begin(), m_ready.end());
 }
 
-void sssp::oracle::relaxable_nodes(todo_output& output) const {
-    for (const auto& node : m_fringe) {
-        if (std::abs(m_result[node.first].distance - node.second) <= DBL_EPSILON) {
-            output.emplace(node.first);
-        }
+template <typename Node, typename Cost>
+void sssp::basic_oracle<Node, Cost>::changed_predecessor(Node node, Node predecessor, Cost distance) {
+    bool ready = std::abs((*m_distances)[node] - distance) <= std::numeric_limits<Cost>::epsilon();
+    if (ready) {
+        m_ready.insert(node);
+    } else {
+        m_ready.erase(node);
     }
 }
 
-void sssp::oracle::changed_predecessor(size_t node, size_t predecessor, double distance) {
-    m_fringe[node] = distance;
+template <typename Node, typename Cost>
+void sssp::basic_oracle<Node, Cost>::relaxed_node(Node node) {
+    m_ready.erase(node);
 }
 
-void sssp::oracle::relaxed_node(size_t node) {
-    m_fringe.erase(node);
-}
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_oracle<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
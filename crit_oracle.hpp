@@ -1,23 +1,31 @@
 #pragma once
 #include "criteria.hpp"
 #include "dijkstra.hpp"
+#include "node_set.hpp"
 #include <cstdlib>
-#include <unordered_map>
 
 namespace sssp {
 
-// Relaxes each node that is reached via its shortest path.
-class oracle : public criteria {
+// Relaxes each node that is reached via its shortest path. The shortest distances are shared by
+// all oracles of a graph, see basic_graph::reference_distances().
+template <typename Node, typename Cost> class basic_oracle : public basic_criteria<Node, Cost> {
   public:
-    oracle(const sssp::graph* graph, size_t start_node);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+
+    basic_oracle(const graph_type* graph, size_t start_node);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
     virtual bool is_complete() const override { return true; }
 
   private:
-    node_map<dijkstra_result> m_result;
-    std::unordered_map<size_t, double> m_fringe;
+    // The final distance of each node.
+    const node_map<Cost>* m_distances;
+    // The fringe nodes whose tentative distance is their final distance.
+    basic_erasable_node_set<Node> m_ready;
 };
 
+using oracle = basic_oracle<size_t, double>;
+
 } // namespace sssp
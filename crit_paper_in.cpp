@@ -1,50 +1,102 @@
 #include "crit_paper_in.hpp"
+#include <boost/assert.hpp>
 
-sssp::paper_in::paper_in(const sssp::graph* graph, size_t start_node) :
-    criteria(graph, start_node),
-    m_node_info(graph->node_count())
-{}
+template <typename Node, typename Cost>
+sssp::basic_paper_in<Node, Cost>::basic_paper_in(const graph_type* graph, size_t start_node)
+    : basic_criteria<Node, Cost>(graph, start_node), m_index(&graph->index()), m_node_info(graph->node_count()),
+      m_threshold_queue(graph->node_count()), m_touched(graph->node_count()) {}
 
-void sssp::paper_in::relaxable_nodes(todo_output& output) const {
-    double min_tent = INFINITY;
-    for (size_t node = 0; node < graph().node_count(); ++node) {
-        if (!m_node_info[node].settled) {
-            min_tent = std::min(min_tent, m_node_info[node].tentative_distance);
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_in<Node, Cost>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        Cost min_tent = this->fringe().top_key();
+        m_threshold_queue.for_each_unordered_up_to(min_tent, [&](Node node) { output.emplace(node); });
     }
+}
 
-    for (size_t node = 0; node < graph().node_count(); ++node) {
-        if (m_node_info[node].settled || m_node_info[node].tentative_distance == INFINITY) {
-            continue;
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_in<Node, Cost>::changed_predecessor(Node node, Node predecessor, Cost distance) {
+    change_distance(node, distance);
+    update_touched();
+}
 
-        double min_incoming = INFINITY;
-        for (edge_info edge : graph().incoming_edges(node)) {
-            if (m_node_info[edge.source].settled) {
-                // predecessor in S => do nothing
-            } else if (m_node_info[edge.source].tentative_distance == INFINITY) {
-                // predecessor in U
-                for (edge_info next_edge : graph().incoming_edges(edge.source)) {
-                    min_incoming = std::min(min_incoming, edge.cost + next_edge.cost);
-                }
-            } else {
-                // predecessor in F
-                min_incoming = std::min(min_incoming, edge.cost);
-            }
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_in<Node, Cost>::relaxed_node(Node node) {
+    settle(node);
+    touch_successors(node);
+    update_touched();
+}
 
-        if (m_node_info[node].tentative_distance - min_incoming <= min_tent) {
-            output.emplace(node);
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_in<Node, Cost>::relaxed_phase(const std::vector<predecessor_change>& changes,
+                                                     const std::vector<Node>& relaxed) {
+    for (Node node : relaxed) {
+        settle(node);
+        touch_successors(node);
+    }
+    for (const predecessor_change& change : changes) {
+        change_distance(change.node, change.distance);
     }
+    update_touched();
 }
 
-void sssp::paper_in::changed_predecessor(size_t node, size_t predecessor, double distance) {
-    BOOST_ASSERT(!m_node_info[node].settled);
-    m_node_info[node].tentative_distance = distance;
+template <typename Node, typename Cost>
+void sssp::basic_paper_in<Node, Cost>::change_distance(Node node, Cost distance) {
+    node_info& info = m_node_info[node];
+    BOOST_ASSERT(!info.settled);
+    if (info.tentative_distance == INFINITY) {
+        // The node moves from U to F, which lowers the thresholds of its successors.
+        touch_successors(node);
+    }
+    info.tentative_distance = distance;
+    m_touched.insert(node);
 }
 
-void sssp::paper_in::relaxed_node(size_t node) {
+template <typename Node, typename Cost> void sssp::basic_paper_in<Node, Cost>::settle(Node node) {
     BOOST_ASSERT(!m_node_info[node].settled);
     m_node_info[node].settled = true;
+    m_threshold_queue.erase(node);
 }
+
+template <typename Node, typename Cost> void sssp::basic_paper_in<Node, Cost>::touch_successors(Node node) {
+    for (const auto& successor : m_index->outgoing(node)) {
+        if (!m_node_info[successor.node].settled) {
+            m_touched.insert(successor.node);
+        }
+    }
+}
+
+template <typename Node, typename Cost> void sssp::basic_paper_in<Node, Cost>::update_touched() {
+    for (Node node : m_touched) {
+        const node_info& info = m_node_info[node];
+        if (info.settled || info.tentative_distance == INFINITY) {
+            // settled or in U
+        } else if (m_threshold_queue.contains(node)) {
+            m_threshold_queue.update(node, threshold(node));
+        } else {
+            m_threshold_queue.push(node, threshold(node));
+        }
+    }
+    m_touched.clear();
+}
+
+template <typename Node, typename Cost> Cost sssp::basic_paper_in<Node, Cost>::threshold(Node node) const {
+    Cost min_incoming = INFINITY;
+    for (const auto& predecessor : m_index->incoming(node)) {
+        const node_info& info = m_node_info[predecessor.node];
+        if (info.settled) {
+            // predecessor in S => do nothing
+        } else if (info.tentative_distance == INFINITY) {
+            // predecessor in U
+            min_incoming = std::min(min_incoming, predecessor.cost + m_index->min_incoming_cost(predecessor.node));
+        } else {
+            // predecessor in F, the incoming edges are sorted by cost so no later one can be smaller
+            min_incoming = std::min(min_incoming, predecessor.cost);
+            break;
+        }
+    }
+    return m_node_info[node].tentative_distance - min_incoming;
+}
+
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_paper_in<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
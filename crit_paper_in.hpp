@@ -1,24 +1,57 @@
 #pragma once
 #include "criteria.hpp"
 #include "graph.hpp"
+#include "graph_index.hpp"
+#include "node_set.hpp"
+#include "priority_queue.hpp"
+#include <vector>
 
 namespace sssp {
 
-class paper_in : public criteria {
+// Relaxes the fringe nodes n with tentative(n) - min_incoming(n) <= min{ tentative(f) : f in F },
+// where min_incoming(n) is the minimum of cost(p, n) over the predecessors p in F and of
+// cost(p, n) + min incoming cost of p over the predecessors p in U. The thresholds are kept in a
+// queue and only recomputed for the nodes whose tentative distance or predecessors changed.
+template <typename Node, typename Cost> class basic_paper_in : public basic_criteria<Node, Cost> {
   public:
-    paper_in(const sssp::graph* graph, size_t start_node);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using typename basic_criteria<Node, Cost>::predecessor_change;
+
+    basic_paper_in(const graph_type* graph, size_t start_node);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
+    // Updates each queue entry at most once per phase instead of once per notification.
+    virtual bool batches_notifications() const override { return true; }
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes,
+                               const std::vector<Node>& relaxed) override;
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return true; }
 
   private:
     struct node_info {
         bool settled = false;
-        double tentative_distance = INFINITY;
+        Cost tentative_distance = INFINITY;
     };
 
+    // Sets the tentative distance of the node, its successors may have to be updated then.
+    void change_distance(Node node, Cost distance);
+    void settle(Node node);
+    void touch_successors(Node node);
+    // Recomputes the thresholds of the touched fringe nodes.
+    void update_touched();
+    // threshold(n) = tentative(n) - min_incoming(n)
+    Cost threshold(Node node) const;
+
+    const basic_graph_index<Node, Cost>* m_index;
     node_map<node_info> m_node_info;
+    // The fringe nodes by threshold, the engine keeps them by tentative distance.
+    priority_queue<Cost, Node> m_threshold_queue;
+    // The nodes whose threshold has to be updated.
+    basic_node_set<Node> m_touched;
 };
 
-}
+using paper_in = basic_paper_in<size_t, double>;
+
+} // namespace sssp
@@ -1,48 +1,127 @@
 #include "crit_paper_out.hpp"
+#include <boost/assert.hpp>
 
-sssp::paper_out::paper_out(const sssp::graph* graph, size_t start_node)
-    : criteria(graph, start_node), m_node_info(graph->node_count()) {}
+template <typename Node, typename Cost>
+sssp::basic_paper_out<Node, Cost>::basic_paper_out(const graph_type* graph, size_t start_node)
+    : basic_criteria<Node, Cost>(graph, start_node), m_index(&graph->index()),
+      m_node_info(graph->make_node_map([index = m_index](size_t n) { return node_info(index->outgoing(n)); })),
+      m_threshold_queue(graph->node_count()), m_touched(graph->node_count()) {}
 
-void sssp::paper_out::relaxable_nodes(todo_output& output) const {
-    double min_threshold = INFINITY;
-    for (size_t node = 0; node < graph().node_count(); ++node) {
-        if (m_node_info[node].settled || m_node_info[node].tentative_distance == INFINITY) {
-            continue;
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_out<Node, Cost>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        Cost min_threshold = m_threshold_queue.top_key();
+        this->fringe().for_each_unordered_up_to(min_threshold, [&](Node node) { output.emplace(node); });
+    }
+}
 
-        for (edge_info edge : graph().outgoing_edges(node)) {
-            if (m_node_info[edge.destination].settled) {
-                // successor in S => do nothing
-            } else if (m_node_info[edge.destination].tentative_distance == INFINITY) {
-                // successor in U
-                for (edge_info next_edge : graph().outgoing_edges(edge.destination)) {
-                    if (!m_node_info[next_edge.destination].settled) {
-                        min_threshold = std::min(min_threshold, m_node_info[node].tentative_distance + edge.cost + next_edge.cost);
-                    }
-                }
-            } else {
-                // successor in F
-                min_threshold = std::min(min_threshold, m_node_info[node].tentative_distance + edge.cost);
-            }
-        }
+template <typename Node, typename Cost>
+void sssp::basic_paper_out<Node, Cost>::changed_predecessor(Node node, Node predecessor, Cost distance) {
+    change_distance(node, distance);
+    update_touched();
+}
+
+template <typename Node, typename Cost> void sssp::basic_paper_out<Node, Cost>::relaxed_node(Node node) {
+    settle(node);
+    remove_settled(node);
+    update_touched();
+}
+
+template <typename Node, typename Cost>
+void sssp::basic_paper_out<Node, Cost>::relaxed_phase(const std::vector<predecessor_change>& changes,
+                                                      const std::vector<Node>& relaxed) {
+    for (Node node : relaxed) {
+        settle(node);
+    }
+    for (const predecessor_change& change : changes) {
+        change_distance(change.node, change.distance);
+    }
+    for (Node node : relaxed) {
+        remove_settled(node);
+    }
+    update_touched();
+}
+
+template <typename Node, typename Cost>
+void sssp::basic_paper_out<Node, Cost>::change_distance(Node node, Cost distance) {
+    node_info& info = m_node_info[node];
+    BOOST_ASSERT(!info.settled);
+    if (info.tentative_distance == INFINITY) {
+        // The node moves from U to F, which changes the thresholds of its predecessors.
+        touch_predecessors(node);
     }
+    info.tentative_distance = distance;
+    m_touched.insert(node);
+}
+
+template <typename Node, typename Cost> void sssp::basic_paper_out<Node, Cost>::settle(Node node) {
+    BOOST_ASSERT(!m_node_info[node].settled);
+    m_node_info[node].settled = true;
+    m_threshold_queue.erase(node);
+}
 
-    for (size_t node = 0; node < graph().node_count(); ++node) {
-        if (m_node_info[node].settled || m_node_info[node].tentative_distance == INFINITY) {
+template <typename Node, typename Cost> void sssp::basic_paper_out<Node, Cost>::remove_settled(Node node) {
+    touch_predecessors(node);
+    for (const auto& predecessor : m_index->incoming(node)) {
+        node_info& info = m_node_info[predecessor.node];
+        if (info.settled || info.tentative_distance != INFINITY || info.outgoing.empty() ||
+            !m_node_info[info.outgoing.front().node].settled) {
             continue;
         }
-        if (m_node_info[node].tentative_distance <= min_threshold) {
-            output.emplace(node);
+        // The minimal unsettled outgoing edge of a predecessor in U is used by the thresholds
+        // of its own predecessors.
+        Cost before = info.outgoing.front().cost;
+        while (!info.outgoing.empty() && m_node_info[info.outgoing.front().node].settled) {
+            info.outgoing.pop_front();
+        }
+        if (info.outgoing.empty() || info.outgoing.front().cost != before) {
+            touch_predecessors(predecessor.node);
         }
     }
 }
 
-void sssp::paper_out::changed_predecessor(size_t node, size_t predecessor, double distance) {
-    BOOST_ASSERT(!m_node_info[node].settled);
-    m_node_info[node].tentative_distance = distance;
+template <typename Node, typename Cost> void sssp::basic_paper_out<Node, Cost>::touch_predecessors(Node node) {
+    for (const auto& predecessor : m_index->incoming(node)) {
+        if (!m_node_info[predecessor.node].settled) {
+            m_touched.insert(predecessor.node);
+        }
+    }
 }
 
-void sssp::paper_out::relaxed_node(size_t node) {
-    BOOST_ASSERT(!m_node_info[node].settled);
-    m_node_info[node].settled = true;
+template <typename Node, typename Cost> void sssp::basic_paper_out<Node, Cost>::update_touched() {
+    for (Node node : m_touched) {
+        const node_info& info = m_node_info[node];
+        if (info.settled || info.tentative_distance == INFINITY) {
+            // settled or in U
+        } else if (m_threshold_queue.contains(node)) {
+            m_threshold_queue.update(node, threshold(node));
+        } else {
+            m_threshold_queue.push(node, threshold(node));
+        }
+    }
+    m_touched.clear();
+}
+
+template <typename Node, typename Cost> Cost sssp::basic_paper_out<Node, Cost>::threshold(Node node) const {
+    Cost tentative = m_node_info[node].tentative_distance;
+    Cost min_threshold = INFINITY;
+    for (const auto& successor : m_index->outgoing(node)) {
+        const node_info& info = m_node_info[successor.node];
+        if (info.settled) {
+            // successor in S => do nothing
+        } else if (info.tentative_distance == INFINITY) {
+            // successor in U
+            if (!info.outgoing.empty()) {
+                min_threshold = std::min(min_threshold, tentative + successor.cost + info.outgoing.front().cost);
+            }
+        } else {
+            // successor in F, the outgoing edges are sorted by cost so no later one can be smaller
+            min_threshold = std::min(min_threshold, tentative + successor.cost);
+            break;
+        }
+    }
+    return min_threshold;
 }
+
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_paper_out<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -1,24 +1,66 @@
 #pragma once
 #include "criteria.hpp"
 #include "graph.hpp"
+#include "graph_index.hpp"
+#include "node_set.hpp"
+#include "priority_queue.hpp"
+#include <vector>
 
 namespace sssp {
 
-class paper_out : public criteria {
+// Relaxes the fringe nodes n with tentative(n) <= min{ threshold(f) : f in F }, where threshold(f)
+// is the minimum of tentative(f) + cost(f, s) over the successors s in F and of
+// tentative(f) + cost(f, s) + cost(s, t) over the successors s in U and their unsettled successors
+// t. The thresholds are kept in a queue and only recomputed for the nodes whose tentative
+// distance or successors changed.
+template <typename Node, typename Cost> class basic_paper_out : public basic_criteria<Node, Cost> {
   public:
-    paper_out(const sssp::graph* graph, size_t start_node);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using typename basic_criteria<Node, Cost>::predecessor_change;
+
+    basic_paper_out(const graph_type* graph, size_t start_node);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
+    // Updates each queue entry at most once per phase instead of once per notification.
+    virtual bool batches_notifications() const override { return true; }
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes,
+                               const std::vector<Node>& relaxed) override;
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return true; }
 
   private:
+    using neighbour_range = typename basic_graph_index<Node, Cost>::neighbour_range;
+
     struct node_info {
+        explicit node_info(neighbour_range outgoing) : outgoing(outgoing) {}
+        // The outgoing edges by ascending cost, without the settled ones at the front while the
+        // node is in U.
+        neighbour_range outgoing;
+        Cost tentative_distance = INFINITY;
         bool settled = false;
-        double tentative_distance = INFINITY;
     };
 
+    // Sets the tentative distance of the node, its predecessors may have to be updated then.
+    void change_distance(Node node, Cost distance);
+    void settle(Node node);
+    // Drops the settled node from the outgoing edges of its predecessors in U. Has to be called
+    // once the classification of all nodes is up to date.
+    void remove_settled(Node node);
+    void touch_predecessors(Node node);
+    // Recomputes the thresholds of the touched fringe nodes.
+    void update_touched();
+    Cost threshold(Node node) const;
+
+    const basic_graph_index<Node, Cost>* m_index;
     node_map<node_info> m_node_info;
+    // The fringe nodes by threshold, the engine keeps them by tentative distance.
+    priority_queue<Cost, Node> m_threshold_queue;
+    // The nodes whose threshold has to be updated.
+    basic_node_set<Node> m_touched;
 };
 
+using paper_out = basic_paper_out<size_t, double>;
+
 } // namespace sssp
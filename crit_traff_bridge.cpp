@@ -1,91 +1,128 @@
 #include "crit_traff_bridge.hpp"
+#include <boost/assert.hpp>
 #include <cfloat>
 
-sssp::traff_bridge::traff_bridge(const sssp::graph* graph, size_t start_node)
-    : criteria(graph, start_node), m_info(graph->make_node_map([&](size_t n) { return node_info(*graph, n); })) {}
+template <typename Node, typename Cost, typename ThresholdQueue>
+sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::basic_traff_bridge(const graph_type* graph, size_t start_node)
+    : basic_criteria<Node, Cost>(graph, start_node),
+      m_info(graph->make_node_map(
+          [index = &graph->index()](size_t n) { return node_info(index->two_hop_incoming(n)); })),
+      m_threshold_queue(graph->node_count()), m_touched(graph->node_count()) {}
 
-void sssp::traff_bridge::relaxable_nodes(todo_output& output) const {
-    if (!m_distance_queue.empty()) {
-        double t = m_distance_queue.top()->tentative;
-
-        auto iter = m_threshold_queue.ordered_begin();
-        auto end = m_threshold_queue.ordered_end();
-        while (iter != end && (*iter)->threshold() <= t) {
-            output.emplace((*iter)->index);
-            ++iter;
-        }
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::relaxable_nodes(todo_output& output) const {
+    if (!this->fringe().empty()) {
+        Cost t = this->fringe().top_key();
+        m_threshold_queue.for_each_unordered_up_to(t, [&](Node node) { output.emplace(node); });
     }
 }
 
-void sssp::traff_bridge::changed_predecessor(size_t node, size_t predecessor, double distance) {
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::changed_predecessor(Node node,
+                                                                               Node predecessor,
+                                                                               Cost distance) {
     node_info& info = m_info[node];
     info.tentative = distance;
 
-    if (info.distance_queue_handle == distance_queue::handle_type()) {
-        info.distance_queue_handle = m_distance_queue.push(&info);
-        info.threshold_queue_handle = m_threshold_queue.push(&info);
-        for (const auto& outgoing_edge : graph().outgoing_edges(node)) {
+    if (!m_threshold_queue.contains(node)) {
+        m_threshold_queue.push(node, info.threshold());
+        for (const auto& outgoing_edge : this->graph().outgoing_edges(node)) {
             node_info& succ = m_info[outgoing_edge.destination];
             if (!succ.settled) {
                 succ.fringe_predecessors += 1;
-                if (succ.threshold_queue_handle != threshold_queue::handle_type()) {
-                    m_threshold_queue.update(succ.threshold_queue_handle);
+                if (m_threshold_queue.contains(outgoing_edge.destination)) {
+                    m_threshold_queue.update(outgoing_edge.destination, succ.threshold());
                 }
             }
         }
     } else {
-        m_distance_queue.update(info.distance_queue_handle);
-        m_threshold_queue.update(info.threshold_queue_handle);
+        m_threshold_queue.update(node, info.threshold());
     }
 }
 
-void sssp::traff_bridge::relaxed_node(size_t node) {
-    node_info& info = m_info[node];
-    info.settled = true;
-    m_distance_queue.erase(info.distance_queue_handle);
-    m_threshold_queue.erase(info.threshold_queue_handle);
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::relaxed_node(Node node) {
+    m_info[node].settled = true;
+    m_threshold_queue.erase(node);
 
-    for (const auto& outgoing_edge : graph().outgoing_edges(node)) {
+    for (const auto& outgoing_edge : this->graph().outgoing_edges(node)) {
         node_info& succ = m_info[outgoing_edge.destination];
         if (!succ.settled) {
-            while (!succ.predecessors.empty() && m_info[succ.predecessors.back().pred].settled) {
-                succ.predecessors.pop_back();
+            while (!succ.predecessors.empty() && m_info[succ.predecessors.front().node].settled) {
+                succ.predecessors.pop_front();
             }
             succ.fringe_predecessors -= 1;
             BOOST_ASSERT(succ.fringe_predecessors != size_t(-1));
-            if (succ.threshold_queue_handle != threshold_queue::handle_type()) {
-                m_threshold_queue.update(succ.threshold_queue_handle);
+            if (m_threshold_queue.contains(outgoing_edge.destination)) {
+                m_threshold_queue.update(outgoing_edge.destination, succ.threshold());
             }
         }
     }
 }
 
-sssp::traff_bridge::node_info::node_info(const sssp::graph& graph, size_t index) : index(index) {
-    for (const auto& incoming_edge : graph.incoming_edges(index)) {
-        double cost = INFINITY;
-        for (const auto& pred_incoming_edge : graph.incoming_edges(incoming_edge.source)) {
-            cost = std::min(cost, pred_incoming_edge.cost);
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::relaxed_phase(const std::vector<predecessor_change>& changes,
+                                                                         const std::vector<Node>& relaxed) {
+    for (Node node : relaxed) {
+        m_info[node].settled = true;
+        m_threshold_queue.erase(node);
+    }
+    for (Node node : relaxed) {
+        for (const auto& outgoing_edge : this->graph().outgoing_edges(node)) {
+            node_info& succ = m_info[outgoing_edge.destination];
+            if (!succ.settled) {
+                while (!succ.predecessors.empty() && m_info[succ.predecessors.front().node].settled) {
+                    succ.predecessors.pop_front();
+                }
+                succ.fringe_predecessors -= 1;
+                BOOST_ASSERT(succ.fringe_predecessors != size_t(-1));
+                m_touched.insert(outgoing_edge.destination);
+            }
         }
-        cost += incoming_edge.cost;
-        predecessors.emplace_back(incoming_edge.source, cost);
     }
-    std::sort(predecessors.begin(), predecessors.end(), [](const auto& a, const auto& b) { return a.cost > b.cost; });
+
+    for (const predecessor_change& change : changes) {
+        node_info& info = m_info[change.node];
+        info.tentative = change.distance;
+        if (!m_threshold_queue.contains(change.node)) {
+            m_threshold_queue.push(change.node, info.threshold());
+            for (const auto& outgoing_edge : this->graph().outgoing_edges(change.node)) {
+                node_info& succ = m_info[outgoing_edge.destination];
+                if (!succ.settled) {
+                    succ.fringe_predecessors += 1;
+                    m_touched.insert(outgoing_edge.destination);
+                }
+            }
+        } else {
+            m_touched.insert(change.node);
+        }
+    }
+
+    for (Node node : m_touched) {
+        if (m_threshold_queue.contains(node)) {
+            m_threshold_queue.update(node, m_info[node].threshold());
+        }
+    }
+    m_touched.clear();
 }
 
-double sssp::traff_bridge::node_info::threshold() const {
+template <typename Node, typename Cost, typename ThresholdQueue>
+Cost sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::node_info::threshold() const {
     if (predecessors.empty()) {
         return -INFINITY;
     } else if (fringe_predecessors > 0) {
         return INFINITY;
     } else {
-        return tentative - predecessors.back().cost;
+        return tentative - predecessors.front().cost;
     }
 }
 
-bool sssp::traff_bridge::node_info_compare_distance::operator()(const node_info* a, const node_info* b) const {
-    return a->tentative > b->tentative;
+template <typename Node, typename Cost, typename ThresholdQueue>
+void sssp::basic_traff_bridge<Node, Cost, ThresholdQueue>::print_counters(std::ostream& out) const {
+    print_queue_counters(out, "traff threshold queue", m_threshold_queue);
 }
 
-bool sssp::traff_bridge::node_info_compare_threshold::operator()(const node_info* a, const node_info* b) const {
-    return a->threshold() > b->threshold();
-}
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template class sssp::basic_traff_bridge<NODE, COST>;                                                               \
+    template class sssp::basic_traff_bridge<NODE, COST, sssp::lazy_priority_queue<COST, NODE>>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -1,56 +1,58 @@
 #pragma once
 #include "criteria.hpp"
-#include <boost/heap/pairing_heap.hpp>
+#include "graph_index.hpp"
+#include "priority_queue.hpp"
 #include <cfloat>
 #include <vector>
 
 namespace sssp {
 
-class traff_bridge : public criteria {
+// Relaxes the fringe nodes whose threshold is not greater than the smallest tentative distance.
+// Every node entering or leaving the fringe changes the thresholds of its successors, a
+// lazy_priority_queue as ThresholdQueue avoids moving entries whose key stays the same.
+template <typename Node, typename Cost, typename ThresholdQueue = priority_queue<Cost, Node>>
+class basic_traff_bridge : public basic_criteria<Node, Cost> {
   public:
-    traff_bridge(const sssp::graph* graph, size_t start_node);
+    using typename basic_criteria<Node, Cost>::graph_type;
+    using typename basic_criteria<Node, Cost>::todo_output;
+    using typename basic_criteria<Node, Cost>::predecessor_change;
+
+    basic_traff_bridge(const graph_type* graph, size_t start_node);
     virtual void relaxable_nodes(todo_output& output) const override;
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) override;
-    virtual void relaxed_node(size_t node) override;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) override;
+    virtual void relaxed_node(Node node) override;
+    // Updates each queue entry at most once per phase instead of once per notification.
+    virtual bool batches_notifications() const override { return true; }
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes,
+                               const std::vector<Node>& relaxed) override;
+    virtual bool uses_fringe_queue() const override { return true; }
     virtual bool is_complete() const override { return false; }
+    virtual void print_counters(std::ostream& out) const override;
 
   private:
-    struct node_info;
-
-    struct node_info_compare_distance {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-
-    // tentative(n) - min{ cost(p, n) + min{ cost(p*, p) : p* predecessor of p } : p predecessor of n in U }
-    struct node_info_compare_threshold {
-        bool operator()(const node_info* a, const node_info* b) const;
-    };
-
-    using distance_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_distance>>;
-    using threshold_queue = boost::heap::pairing_heap<node_info*, boost::heap::compare<node_info_compare_threshold>>;
-
-    struct pred_info {
-        pred_info(size_t pred, double cost) : pred(pred), cost(cost) {}
-        size_t pred;
-        double cost; // cost(p, n) + min{ cost(p*, p) : p* predecessor of p }
-    };
+    using neighbour_range = typename basic_graph_index<Node, Cost>::neighbour_range;
 
     struct node_info {
-        node_info(const sssp::graph& graph, size_t index);
-        size_t index;
-        double tentative = INFINITY;
+        explicit node_info(neighbour_range predecessors) : predecessors(predecessors) {}
+        Cost tentative = INFINITY;
         bool settled = false;
-        std::vector<pred_info> predecessors;
+        // The predecessors p with cost(p, n) + min{ cost(p*, p) : p* predecessor of p } by ascending
+        // cost, without the settled ones at the front.
+        neighbour_range predecessors;
         size_t fringe_predecessors = 0;
-        distance_queue::handle_type distance_queue_handle;
-        threshold_queue::handle_type threshold_queue_handle;
 
-        double threshold() const;
+        // tentative(n) - min{ cost(p, n) + min{ cost(p*, p) : p* predecessor of p } : p predecessor of n in U }
+        Cost threshold() const;
     };
 
     node_map<node_info> m_info;
-    distance_queue m_distance_queue;
-    threshold_queue m_threshold_queue;
+    // The fringe nodes by threshold, the engine keeps them by tentative distance.
+    ThresholdQueue m_threshold_queue;
+    // The nodes whose threshold has to be updated at the end of relaxed_phase.
+    basic_node_set<Node> m_touched;
 };
 
+using traff_bridge = basic_traff_bridge<size_t, double>;
+using lazy_traff_bridge = basic_traff_bridge<size_t, double, lazy_priority_queue<double, size_t>>;
+
 } // namespace sssp
\ No newline at end of file
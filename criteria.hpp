@@ -1,40 +1,97 @@
 #pragma once
 #include "graph.hpp"
-#include <unordered_set>
+#include "node_set.hpp"
+#include "priority_queue.hpp"
+#include <boost/assert.hpp>
+#include <cmath>
+#include <ostream>
+#include <vector>
 
 namespace sssp {
 
-class criteria {
+template <typename Node, typename Cost> class basic_criteria {
   public:
-    using todo_output = std::unordered_set<size_t>;
+    using node_type = Node;
+    using cost_type = Cost;
+    using graph_type = basic_graph<Node, Cost>;
+    using todo_output = basic_node_set<Node>;
+    // The fringe nodes by tentative distance, see fringe().
+    using fringe_queue = priority_queue<Cost, Node>;
 
-    criteria(const graph* graph, size_t start_node) : m_graph(graph), m_start_node(start_node) {}
+    // The final change of the predecessor of a node in a phase, see relaxed_phase.
+    struct predecessor_change {
+        Node node;
+        Node predecessor;
+        Cost distance;
+    };
 
-    virtual ~criteria() = default;
+    basic_criteria(const graph_type* graph, size_t start_node)
+        : m_graph(graph), m_start_node(static_cast<Node>(start_node)) {}
 
-    // Called at the start of each relaxation phase to find nodes to relax.
+    virtual ~basic_criteria() = default;
+
+    // Called at the start of each relaxation phase to find nodes to relax. The output is sized for
+    // the nodes of the graph and might contain the nodes of other criteria already.
     virtual void relaxable_nodes(todo_output& output) const = 0;
 
     // Called when a node in the fringe or unexplored set gets a better predecessor
     // assigned. Called before the respective relaxed_node.
-    virtual void changed_predecessor(size_t node, size_t predecessor, double distance) = 0;
+    virtual void changed_predecessor(Node node, Node predecessor, Cost distance) = 0;
 
     // Called for each node that is being relaxed. Note that no all nodes returned
     // by relaxable_nodes might be relaxed and note that this might be called
     // for nodes not returned by relaxable_nodes. Called after the appropriate
     // changed_predecessor calls.
-    virtual void relaxed_node(size_t node) = 0;
+    virtual void relaxed_node(Node node) = 0;
 
     // Return true if the criteria alone is complete.
     virtual bool is_complete() const = 0;
 
+    // Return true to receive the notifications of each phase at once by relaxed_phase instead of
+    // changed_predecessor and relaxed_node.
+    virtual bool batches_notifications() const { return false; }
+
+    // Called after each phase if batches_notifications returns true. changes contains the final
+    // change of each node in the phase and relaxed the relaxed nodes sorted by index. The start node
+    // is reported as change without relaxed nodes before the first phase. By default, the changes
+    // and then the relaxed nodes are passed to the single notifications.
+    virtual void relaxed_phase(const std::vector<predecessor_change>& changes, const std::vector<Node>& relaxed) {
+        for (const predecessor_change& change : changes) {
+            changed_predecessor(change.node, change.predecessor, change.distance);
+        }
+        for (Node node : relaxed) {
+            relaxed_node(node);
+        }
+    }
+
+    // Return true to use the fringe queue of the engine, see fringe().
+    virtual bool uses_fringe_queue() const { return false; }
+
+    // Called by the engine before the start node is reported if uses_fringe_queue returns true.
+    void attach_fringe_queue(const fringe_queue* queue) { m_fringe_queue = queue; }
+
+    // Writes the counters the criteria collected during the run, if any.
+    virtual void print_counters(std::ostream& out) const {}
+
   protected:
-    const sssp::graph& graph() const { return *m_graph; }
-    size_t start_node() const { return m_start_node; }
+    const graph_type& graph() const { return *m_graph; }
+    Node start_node() const { return m_start_node; }
+
+    // The fringe nodes by their tentative distance. The engine maintains a single queue for all
+    // criteria of a run: A node is pushed or updated right before changed_predecessor reports it
+    // and erased right before relaxed_node reports it. With batched notifications, the queue is
+    // already up to date for the whole phase when relaxed_phase is called.
+    const fringe_queue& fringe() const {
+        BOOST_ASSERT(m_fringe_queue);
+        return *m_fringe_queue;
+    }
 
   private:
-    const sssp::graph* m_graph;
-    size_t m_start_node;
+    const graph_type* m_graph;
+    Node m_start_node;
+    const fringe_queue* m_fringe_queue = nullptr;
 };
 
+using criteria = basic_criteria<size_t, double>;
+
 } // namespace sssp
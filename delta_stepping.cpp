@@ -0,0 +1,194 @@
+#include "delta_stepping.hpp"
+#include "graph_index.hpp"
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <boost/assert.hpp>
+
+template <typename Node, typename Cost> Cost sssp::default_delta(const basic_graph<Node, Cost>& graph) {
+    const basic_graph_index<Node, Cost>& index = graph.index();
+    Cost max_cost = 0;
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        auto outgoing = index.outgoing(node);
+        if (!outgoing.empty()) {
+            max_cost = std::max(max_cost, outgoing.end()[-1].cost);
+        }
+    }
+    if (max_cost <= 0) {
+        return Cost(1);
+    }
+    double average_degree = static_cast<double>(graph.edge_count()) / graph.node_count();
+    return static_cast<Cost>(max_cost / std::max(1.0, average_degree));
+}
+
+template <typename Node, typename Cost>
+sssp::basic_label_correcting_result<Node, Cost>
+sssp::delta_stepping(const basic_graph<Node, Cost>& graph, size_t start_node, Cost delta) {
+    BOOST_ASSERT(delta > 0);
+    using neighbour = typename basic_graph_index<Node, Cost>::neighbour;
+    const size_t no_bucket = size_t(-1);
+    const basic_graph_index<Node, Cost>& index = graph.index();
+
+    basic_label_correcting_result<Node, Cost> result;
+    node_map<basic_dijkstra_result<Node, Cost>>& info = result.nodes;
+    info = graph.make_node_map([](size_t i) { return basic_dijkstra_result<Node, Cost>(); });
+
+    Cost max_cost = 0;
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        auto outgoing = index.outgoing(node);
+        if (!outgoing.empty()) {
+            max_cost = std::max(max_cost, outgoing.end()[-1].cost);
+        }
+    }
+    // The bucket numbers of all distances have to fit into size_t. Buckets that narrow hold a
+    // single distance up to rounding, so a wider delta hardly changes the phases.
+    delta = std::max(delta, static_cast<Cost>(max_cost * graph.node_count() / Cost(uint64_t(1) << 52)));
+    result.delta = delta;
+
+    // The outgoing edges are sorted by cost, the light ones come first.
+    std::vector<const neighbour*> heavy_begin(graph.node_count());
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        auto outgoing = index.outgoing(node);
+        heavy_begin[node] = std::upper_bound(
+            outgoing.begin(), outgoing.end(), delta, [](Cost d, const neighbour& edge) { return d < edge.cost; });
+    }
+
+    // The buckets are a cyclic array of slots. All tentative distances in the buckets are less
+    // than the end of the current bucket plus the maximal edge cost, so with enough slots the
+    // buckets in use never share one. Small deltas would need more slots than there are nodes,
+    // then the nodes in buckets beyond the slots wait in a queue by bucket instead.
+    // Decreasing a node leaves its old entry in a slot behind, in_bucket tells the valid entries
+    // apart.
+    const Cost slots_needed = max_cost / delta + 3;
+    const size_t slot_count =
+        slots_needed < graph.node_count() + 3 ? static_cast<size_t>(slots_needed) : graph.node_count() + 3;
+    std::vector<std::vector<Node>> slots(slot_count);
+    priority_queue<size_t, Node> beyond_slots(graph.node_count());
+    std::vector<size_t> in_bucket(graph.node_count(), no_bucket);
+    size_t current = 0;
+    size_t fringe_size = 0;
+    auto insert = [&](Node node, Cost distance) {
+        size_t bucket = static_cast<size_t>(distance / delta);
+        BOOST_ASSERT(current <= bucket);
+        if (in_bucket[node] == bucket) {
+            return;
+        }
+        fringe_size += in_bucket[node] == no_bucket;
+        in_bucket[node] = bucket;
+        if (bucket - current < slots.size()) {
+            if (!beyond_slots.empty() && beyond_slots.contains(node)) {
+                beyond_slots.erase(node);
+            }
+            slots[bucket % slots.size()].push_back(node);
+        } else if (beyond_slots.contains(node)) {
+            beyond_slots.decrease(node, bucket);
+        } else {
+            beyond_slots.push(node, bucket);
+        }
+    };
+    // Removes the valid entries of the current bucket, ordered by node index.
+    auto take_current = [&](std::vector<Node>& nodes) {
+        nodes.clear();
+        std::vector<Node>& slot = slots[current % slots.size()];
+        for (Node node : slot) {
+            if (in_bucket[node] == current) {
+                in_bucket[node] = no_bucket;
+                nodes.push_back(node);
+            }
+        }
+        slot.clear();
+        while (!beyond_slots.empty() && beyond_slots.top_key() == current) {
+            Node node = beyond_slots.pop();
+            in_bucket[node] = no_bucket;
+            nodes.push_back(node);
+        }
+        std::sort(nodes.begin(), nodes.end());
+    };
+
+    // The relaxations of a phase are computed from the distances at its start and applied after.
+    struct request {
+        Node node;
+        Node predecessor;
+        Cost distance;
+    };
+    std::vector<request> requests;
+    auto request_edges = [&](Node node, const neighbour* begin, const neighbour* end) {
+        for (const neighbour* edge = begin; edge != end; ++edge) {
+            requests.push_back(request{edge->node, node, info[node].distance + edge->cost});
+        }
+    };
+    auto apply_requests = [&] {
+        for (const request& r : requests) {
+            if (r.distance < info[r.node].distance) {
+                info[r.node].distance = r.distance;
+                info[r.node].predecessor = r.predecessor;
+                insert(r.node, r.distance);
+            }
+        }
+        requests.clear();
+    };
+
+    info[start_node].distance = 0;
+    insert(static_cast<Node>(start_node), 0);
+
+    // Whether the light edges of a node were relaxed before, and the nodes removed from the current
+    // bucket, whose heavy edges are relaxed once it stays empty.
+    std::vector<bool> relaxed_before(graph.node_count(), false);
+    std::vector<Node> removed;
+    std::vector<Node> nodes;
+    int phase = 0;
+    while (fringe_size > 0) {
+        take_current(nodes);
+        if (nodes.empty()) {
+            // Once all nodes wait beyond the slots, the empty buckets in between are skipped.
+            current = fringe_size == beyond_slots.size() ? beyond_slots.top_key() : current + 1;
+            continue;
+        }
+
+        removed.clear();
+        while (!nodes.empty()) {
+            label_correcting_phase stats;
+            stats.relaxed = nodes.size();
+            stats.fringe_size = fringe_size;
+            fringe_size -= nodes.size();
+            for (Node node : nodes) {
+                info[node].relaxation_phase = phase;
+                info[node].fringe_size = stats.fringe_size;
+                if (relaxed_before[node]) {
+                    stats.rerelaxed += 1;
+                } else {
+                    relaxed_before[node] = true;
+                    removed.push_back(node);
+                }
+                request_edges(node, index.outgoing(node).begin(), heavy_begin[node]);
+            }
+            apply_requests();
+            result.phases.push_back(stats);
+            ++phase;
+            take_current(nodes);
+        }
+
+        label_correcting_phase stats;
+        stats.fringe_size = fringe_size;
+        std::sort(removed.begin(), removed.end());
+        for (Node node : removed) {
+            if (heavy_begin[node] != index.outgoing(node).end()) {
+                stats.relaxed += 1;
+                request_edges(node, heavy_begin[node], index.outgoing(node).end());
+            }
+        }
+        if (stats.relaxed > 0) {
+            apply_requests();
+            result.phases.push_back(stats);
+            ++phase;
+        }
+        ++current;
+    }
+
+    return result;
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template COST sssp::default_delta(const basic_graph<NODE, COST>&);                                                 \
+    template sssp::basic_label_correcting_result<NODE, COST> sssp::delta_stepping(                                     \
+        const basic_graph<NODE, COST>&, size_t, COST);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -0,0 +1,23 @@
+#pragma once
+#include "graph.hpp"
+#include "label_correcting.hpp"
+
+namespace sssp {
+
+// Returns the bucket width for delta_stepping() proposed by Meyer and Sanders: the maximal edge
+// cost divided by the average out-degree, or 1 if all edges cost 0.
+template <typename Node, typename Cost> Cost default_delta(const basic_graph<Node, Cost>& graph);
+
+// Runs Meyer and Sanders' Δ-stepping. Unlike dijkstra(), this is label correcting: The nodes are
+// kept in buckets of width delta by tentative distance. Each phase removes all nodes of the
+// smallest non-empty bucket and relaxes their light edges (cost <= delta) with the distances at
+// the start of the phase. Nodes that improve and fall into the same bucket again are relaxed
+// again in the next phase. Once the bucket stays empty, an additional phase relaxes the heavy
+// edges of all nodes removed from it, unless none of them has heavy edges. Only the light edges
+// count as re-relaxations. Deltas too small to number the buckets of all distances are raised, the
+// result holds the delta that was used.
+template <typename Node, typename Cost>
+basic_label_correcting_result<Node, Cost>
+delta_stepping(const basic_graph<Node, Cost>& graph, size_t start_node, Cost delta);
+
+} // namespace sssp
@@ -1,74 +1,40 @@
 #include "dijkstra.hpp"
-#include <boost/assert.hpp>
-#include <limits>
-
-sssp::node_map<sssp::dijkstra_result>
-sssp::dijkstra(const graph& graph, size_t start_node, boost::base_collection<criteria>& criteria) {
-    node_map<dijkstra_result> info = graph.make_node_map([](size_t i) { return dijkstra_result(); });
-    int current_phase = 0;
-    size_t fringe_size = 0;
-
-    // Put the start node in the fringe set.
-    info[start_node].distance = 0.0;
-    for (auto& crit : criteria) {
-        crit.changed_predecessor(start_node, size_t(-1), 0.0);
-    }
-    fringe_size += 1;
-
-    criteria::todo_output todo;
-    todo.reserve(graph.node_count());
-    while (true) {
-        // Find nodes to be relaxed.
-        todo.clear();
-        for (auto& crit : criteria) {
-            crit.relaxable_nodes(todo);
-        }
-
-        // If there is nothing more to do, we are done.
-        if (todo.empty()) {
-            break;
-        }
-
-        // First all todo nodes will be set to settled. This exposes some errors
-        // and simulates the parallel relaxation better. If this does not happen
-        // now but later in the loop, the arbritary relaxation order might hide
-        // errors.
-        for (size_t node : todo) {
-            info[node].relaxation_phase = current_phase;
-            info[node].fringe_size = fringe_size;
-            fringe_size -= 1;
-            BOOST_ASSERT(fringe_size != size_t(-1));
-        }
-
-        // Relax each node.
-        for (size_t node : todo) {
-            dijkstra_result& current_node = info[node];
-            BOOST_ASSERT(current_node.settled()); // set above
-
-            for (const edge_info& edge : graph.outgoing_edges(node)) {
-                dijkstra_result& destination_node = info[edge.destination];
-                if (!destination_node.settled() && current_node.distance + edge.cost < destination_node.distance) {
-                    if (destination_node.unexplored()) {
-                        fringe_size += 1;
-                        BOOST_ASSERT(fringe_size <= graph.node_count());
-                    }
-                    destination_node.distance = current_node.distance + edge.cost;
-                    destination_node.predecessor = node;
-                    for (auto& crit : criteria) {
-                        crit.changed_predecessor(edge.destination, node, destination_node.distance);
-                    }
-                }
-            }
+#include "dijkstra_engine.hpp"
+#include "radix_heap.hpp"
+
+template <typename Node, typename Cost>
+sssp::node_map<sssp::basic_dijkstra_result<Node, Cost>>
+sssp::dijkstra(const basic_graph<Node, Cost>& graph,
+               size_t start_node,
+               boost::base_collection<basic_criteria<Node, Cost>>& criteria,
+               size_t thread_count) {
+    dynamic_criteria_set<Node, Cost> set(criteria);
+    return dijkstra_engine<Node, Cost, dynamic_criteria_set<Node, Cost>>::run(graph, start_node, set, thread_count);
+}
 
-            for (auto& crit : criteria) {
-                crit.relaxed_node(node);
+template <typename Node, typename Cost>
+sssp::node_map<Cost> sssp::shortest_distances(const basic_graph<Node, Cost>& graph, size_t start_node) {
+    node_map<Cost> distances(graph.node_count(), INFINITY);
+    std::vector<bool> settled(graph.node_count(), false);
+    radix_heap<Node, Cost> queue(graph.node_count());
+    distances[start_node] = 0;
+    queue.push(static_cast<Node>(start_node), 0);
+    while (!queue.empty()) {
+        Node node = queue.pop();
+        settled[node] = true;
+        for (const auto& edge : graph.outgoing_edges(node)) {
+            Cost distance = distances[node] + edge.cost;
+            if (!settled[edge.destination] && distance < distances[edge.destination]) {
+                distances[edge.destination] = distance;
+                queue.push(edge.destination, distance);
             }
         }
-
-        // Next round.
-        ++current_phase;
     }
-
-    BOOST_ASSERT(fringe_size == 0);
-    return info;
+    return distances;
 }
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template sssp::node_map<sssp::basic_dijkstra_result<NODE, COST>> sssp::dijkstra(                                  \
+        const basic_graph<NODE, COST>&, size_t, boost::base_collection<basic_criteria<NODE, COST>>&, size_t);          \
+    template sssp::node_map<COST> sssp::shortest_distances(const basic_graph<NODE, COST>&, size_t);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -3,23 +3,41 @@
 #include "criteria.hpp"
 #include "graph.hpp"
 #include <boost/poly_collection/base_collection.hpp>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 
 namespace sssp {
 
-struct dijkstra_result {
-    size_t predecessor = size_t(-1);
-    double distance = INFINITY;
+template <typename Node, typename Cost> struct basic_dijkstra_result {
+    Node predecessor = Node(-1);
+    Cost distance = INFINITY;
     int relaxation_phase = -1;
     size_t fringe_size = -1;
 
-    bool unexplored() const { return relaxation_phase == -1 && predecessor == size_t(-1); }
-    bool fringe() const { return relaxation_phase == -1 && predecessor != size_t(-1); }
+    bool unexplored() const { return relaxation_phase == -1 && predecessor == Node(-1); }
+    bool fringe() const { return relaxation_phase == -1 && predecessor != Node(-1); }
     bool settled() const { return relaxation_phase != -1; }
 };
 
-node_map<dijkstra_result> dijkstra(const graph& graph, size_t start_node, boost::base_collection<criteria>& criteria);
+using dijkstra_result = basic_dijkstra_result<size_t, double>;
+
+// Runs the phases of a label setting SSSP algorithm. Each phase relaxes all nodes returned by the
+// relaxable_nodes of any of the criteria. With more than one thread the nodes of a phase are
+// relaxed in parallel and, with a large fringe, multiple criteria are asked for their relaxable
+// nodes in parallel. The criteria still receive their notifications from a single thread and in
+// a deterministic order, so the results do not depend on the number of threads.
+template <typename Node, typename Cost>
+node_map<basic_dijkstra_result<Node, Cost>> dijkstra(const basic_graph<Node, Cost>& graph,
+                                                     size_t start_node,
+                                                     boost::base_collection<basic_criteria<Node, Cost>>& criteria,
+                                                     size_t thread_count = 1);
+
+// Returns the distances from the start node computed by plain Dijkstra's algorithm on a radix heap,
+// without the phases and the bookkeeping of dijkstra(). basic_graph::reference_distances() keeps
+// the result to share it between all users of a graph.
+template <typename Node, typename Cost>
+node_map<Cost> shortest_distances(const basic_graph<Node, Cost>& graph, size_t start_node);
 
 } // namespace sssp
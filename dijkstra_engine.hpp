@@ -0,0 +1,473 @@
+#pragma once
+#include "criteria.hpp"
+#include "dijkstra.hpp"
+#include "graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <boost/assert.hpp>
+#include <boost/poly_collection/base_collection.hpp>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sssp {
+
+// Forwards the calls of the engine to criteria chosen at run time with virtual calls.
+template <typename Node, typename Cost> class dynamic_criteria_set {
+  public:
+    using todo_output = typename basic_criteria<Node, Cost>::todo_output;
+    using predecessor_change = typename basic_criteria<Node, Cost>::predecessor_change;
+    using fringe_queue = typename basic_criteria<Node, Cost>::fringe_queue;
+
+    explicit dynamic_criteria_set(boost::base_collection<basic_criteria<Node, Cost>>& criteria)
+        : m_criteria(criteria) {
+        for (const auto& crit : m_criteria) {
+            m_batching.push_back(crit.batches_notifications());
+            m_pointers.push_back(&crit);
+        }
+        m_any_batching = std::find(m_batching.begin(), m_batching.end(), true) != m_batching.end();
+    }
+
+    bool batches() const { return m_any_batching; }
+
+    bool uses_fringe_queue() const {
+        return std::any_of(
+            m_criteria.begin(), m_criteria.end(), [](const auto& crit) { return crit.uses_fringe_queue(); });
+    }
+    void attach_fringe_queue(const fringe_queue* queue) {
+        for (auto& crit : m_criteria) {
+            crit.attach_fringe_queue(queue);
+        }
+    }
+
+    size_t size() const { return m_pointers.size(); }
+
+    void relaxable_nodes(todo_output& output) const {
+        for (const auto& crit : m_criteria) {
+            crit.relaxable_nodes(output);
+        }
+    }
+    // Only asks the criteria at the index, in the order of the collection.
+    void relaxable_nodes(size_t index, todo_output& output) const { m_pointers[index]->relaxable_nodes(output); }
+    void changed_predecessor(Node node, Node predecessor, Cost distance) {
+        size_t index = 0;
+        for (auto& crit : m_criteria) {
+            if (!m_batching[index++]) {
+                crit.changed_predecessor(node, predecessor, distance);
+            }
+        }
+    }
+    void relaxed_node(Node node) {
+        size_t index = 0;
+        for (auto& crit : m_criteria) {
+            if (!m_batching[index++]) {
+                crit.relaxed_node(node);
+            }
+        }
+    }
+    void relaxed_phase(const std::vector<predecessor_change>& changes, const std::vector<Node>& relaxed) {
+        size_t index = 0;
+        for (auto& crit : m_criteria) {
+            if (m_batching[index++]) {
+                crit.relaxed_phase(changes, relaxed);
+            }
+        }
+    }
+
+  private:
+    boost::base_collection<basic_criteria<Node, Cost>>& m_criteria;
+    // The criteria in the order of the collection.
+    std::vector<const basic_criteria<Node, Cost>*> m_pointers;
+    // batches_notifications() of each criteria in the order of the collection.
+    std::vector<bool> m_batching;
+    bool m_any_batching;
+};
+
+// Forwards the calls of the engine to criteria known at compile time. The calls are qualified
+// with the type of each criteria and therefore bypass the virtual dispatch.
+template <typename Node, typename Cost, typename... Criteria> class static_criteria_set {
+  public:
+    using todo_output = typename basic_criteria<Node, Cost>::todo_output;
+    using predecessor_change = typename basic_criteria<Node, Cost>::predecessor_change;
+    using fringe_queue = typename basic_criteria<Node, Cost>::fringe_queue;
+
+    explicit static_criteria_set(std::tuple<Criteria...>& criteria) : m_criteria(criteria) {}
+
+    bool batches() const {
+        bool result = false;
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            result = result || crit.type::batches_notifications();
+        });
+        return result;
+    }
+
+    bool uses_fringe_queue() const {
+        bool result = false;
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            result = result || crit.type::uses_fringe_queue();
+        });
+        return result;
+    }
+    void attach_fringe_queue(const fringe_queue* queue) {
+        for_each([&](auto& crit) { crit.attach_fringe_queue(queue); });
+    }
+
+    size_t size() const { return sizeof...(Criteria); }
+
+    void relaxable_nodes(todo_output& output) const {
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            crit.type::relaxable_nodes(output);
+        });
+    }
+    // Only asks the criteria at the index in the tuple.
+    void relaxable_nodes(size_t index, todo_output& output) const {
+        size_t current = 0;
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            if (current++ == index) {
+                crit.type::relaxable_nodes(output);
+            }
+        });
+    }
+    void changed_predecessor(Node node, Node predecessor, Cost distance) {
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            if (!crit.type::batches_notifications()) {
+                crit.type::changed_predecessor(node, predecessor, distance);
+            }
+        });
+    }
+    void relaxed_node(Node node) {
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            if (!crit.type::batches_notifications()) {
+                crit.type::relaxed_node(node);
+            }
+        });
+    }
+    void relaxed_phase(const std::vector<predecessor_change>& changes, const std::vector<Node>& relaxed) {
+        for_each([&](auto& crit) {
+            using type = std::decay_t<decltype(crit)>;
+            if (crit.type::batches_notifications()) {
+                crit.type::relaxed_phase(changes, relaxed);
+            }
+        });
+    }
+
+  private:
+    template <typename Fun> void for_each(const Fun& fn) const {
+        for_each(fn, std::index_sequence_for<Criteria...>());
+    }
+    template <typename Fun, size_t... Index> void for_each(const Fun& fn, std::index_sequence<Index...>) const {
+        (void)std::initializer_list<int>{(fn(std::get<Index>(m_criteria)), 0)...};
+    }
+
+    std::tuple<Criteria...>& m_criteria;
+};
+
+// The phases of dijkstra() for both ways to pass the criteria. CriteriaSet is either a
+// dynamic_criteria_set or a static_criteria_set.
+template <typename Node, typename Cost, typename CriteriaSet> class dijkstra_engine {
+  public:
+    using dijkstra_result = basic_dijkstra_result<Node, Cost>;
+    using edge_info = basic_edge_info<Node, Cost>;
+    using todo_output = typename basic_criteria<Node, Cost>::todo_output;
+    using predecessor_change = typename basic_criteria<Node, Cost>::predecessor_change;
+    using fringe_queue = typename basic_criteria<Node, Cost>::fringe_queue;
+
+    static node_map<dijkstra_result> run(const basic_graph<Node, Cost>& graph,
+                                         size_t start_node_index,
+                                         CriteriaSet& criteria,
+                                         size_t thread_count) {
+        const Node start_node = static_cast<Node>(start_node_index);
+        node_map<dijkstra_result> info = graph.make_node_map([](size_t i) { return dijkstra_result(); });
+        int current_phase = 0;
+        size_t fringe_size = 0;
+
+        // Only used for criteria that batch their notifications: The nodes whose predecessor
+        // changed during the current phase and their final changes.
+        const bool batches = criteria.batches();
+        todo_output changed(batches ? graph.node_count() : 0);
+        std::vector<predecessor_change> changes;
+
+        // The fringe nodes by tentative distance, shared by the criteria that use it.
+        fringe_queue shared_queue(criteria.uses_fringe_queue() ? graph.node_count() : 0);
+        fringe_queue* queue = nullptr;
+        if (criteria.uses_fringe_queue()) {
+            queue = &shared_queue;
+            criteria.attach_fringe_queue(queue);
+        }
+
+        // Put the start node in the fringe set.
+        info[start_node].distance = 0;
+        notify_changed(criteria, queue, start_node, Node(-1), 0);
+        if (batches) {
+            changes.push_back(predecessor_change{start_node, Node(-1), 0});
+            criteria.relaxed_phase(changes, std::vector<Node>());
+        }
+        fringe_size += 1;
+
+        // Only used by the parallel relaxation: The tentative distances and the rank of the
+        // predecessor of each node during a phase.
+        std::vector<std::atomic<Cost>> tentative(thread_count > 1 ? graph.node_count() : 0);
+        std::vector<std::atomic<size_t>> winner(tentative.size());
+        for (size_t node = 0; node < tentative.size(); ++node) {
+            tentative[node].store(info[node].distance, std::memory_order_relaxed);
+            winner[node].store(size_t(-1), std::memory_order_relaxed);
+        }
+
+        // Only used to ask the criteria in parallel: The relaxable nodes of each criteria.
+        const bool parallel_criteria = thread_count > 1 && criteria.size() > 1;
+        std::vector<todo_output> criteria_todo(parallel_criteria ? criteria.size() : 0,
+                                               todo_output(graph.node_count()));
+
+        todo_output todo(graph.node_count());
+        while (true) {
+            // Find nodes to be relaxed.
+            todo.clear();
+            if (parallel_criteria && fringe_size >= min_parallel_fringe_size) {
+                relaxable_nodes_parallel(criteria, criteria_todo, todo, thread_count);
+            } else {
+                criteria.relaxable_nodes(todo);
+            }
+
+            // If there is nothing more to do, we are done.
+            if (todo.empty()) {
+                break;
+            }
+            // Relaxing the nodes in the order of their indices touches the node maps in order.
+            todo.sort();
+
+            // First all todo nodes will be set to settled. This exposes some errors
+            // and simulates the parallel relaxation better. If this does not happen
+            // now but later in the loop, the arbritary relaxation order might hide
+            // errors.
+            for (Node node : todo) {
+                info[node].relaxation_phase = current_phase;
+                info[node].fringe_size = fringe_size;
+                fringe_size -= 1;
+                BOOST_ASSERT(fringe_size != size_t(-1));
+            }
+
+            todo_output* changed_output = batches ? &changed : nullptr;
+            if (thread_count > 1) {
+                relax_parallel(graph,
+                               todo.nodes(),
+                               info,
+                               tentative,
+                               winner,
+                               criteria,
+                               queue,
+                               changed_output,
+                               fringe_size,
+                               thread_count);
+            } else {
+                relax_serial(graph, todo.nodes(), info, criteria, queue, changed_output, fringe_size);
+            }
+
+            if (batches) {
+                changes.clear();
+                for (Node node : changed) {
+                    changes.push_back(predecessor_change{node, info[node].predecessor, info[node].distance});
+                }
+                changed.clear();
+                criteria.relaxed_phase(changes, todo.nodes());
+            }
+
+            // Next round.
+            ++current_phase;
+        }
+
+        BOOST_ASSERT(fringe_size == 0);
+        return info;
+    }
+
+  private:
+    // Below this fringe size, starting threads to ask the criteria costs more than it saves.
+    static constexpr size_t min_parallel_fringe_size = 1 << 10;
+    // The number of edges each thread of the parallel relaxation gets at least.
+    static constexpr size_t min_parallel_relax_edges = 1 << 13;
+
+    // Asks each criteria in its own thread, as far as there are threads, for its relaxable nodes.
+    // relaxable_nodes is const and the criteria are independent, so only the outputs have to be
+    // separate. They are merged into todo afterwards.
+    static void relaxable_nodes_parallel(const CriteriaSet& criteria,
+                                         std::vector<todo_output>& criteria_todo,
+                                         todo_output& todo,
+                                         size_t thread_count) {
+        parallel_for(criteria.size(), thread_count, [&](size_t index) {
+            criteria.relaxable_nodes(index, criteria_todo[index]);
+        });
+        for (todo_output& output : criteria_todo) {
+            todo.insert(output.begin(), output.end());
+            output.clear();
+        }
+    }
+
+    // Updates the fringe queue unless it is null, then notifies the criteria.
+    static void notify_changed(CriteriaSet& criteria, fringe_queue* queue, Node node, Node predecessor, Cost distance) {
+        if (queue) {
+            if (queue->contains(node)) {
+                queue->decrease(node, distance);
+            } else {
+                queue->push(node, distance);
+            }
+        }
+        criteria.changed_predecessor(node, predecessor, distance);
+    }
+    static void notify_relaxed(CriteriaSet& criteria, fringe_queue* queue, Node node) {
+        if (queue) {
+            queue->erase(node);
+        }
+        criteria.relaxed_node(node);
+    }
+
+    // Relaxes the nodes of a phase one after the other. The improved nodes are added to changed
+    // unless it is null.
+    static void relax_serial(const basic_graph<Node, Cost>& graph,
+                             const std::vector<Node>& nodes,
+                             node_map<dijkstra_result>& info,
+                             CriteriaSet& criteria,
+                             fringe_queue* queue,
+                             todo_output* changed,
+                             size_t& fringe_size) {
+        for (Node node : nodes) {
+            dijkstra_result& current_node = info[node];
+            BOOST_ASSERT(current_node.settled()); // set above
+
+            for (const edge_info& edge : graph.outgoing_edges(node)) {
+                dijkstra_result& destination_node = info[edge.destination];
+                if (!destination_node.settled() && current_node.distance + edge.cost < destination_node.distance) {
+                    if (destination_node.unexplored()) {
+                        fringe_size += 1;
+                        BOOST_ASSERT(fringe_size <= graph.node_count());
+                    }
+                    destination_node.distance = current_node.distance + edge.cost;
+                    destination_node.predecessor = node;
+                    notify_changed(criteria, queue, edge.destination, node, destination_node.distance);
+                    if (changed) {
+                        changed->insert(edge.destination);
+                    }
+                }
+            }
+
+            notify_relaxed(criteria, queue, node);
+        }
+    }
+
+    // Relaxes the nodes of a phase with multiple threads. Each thread handles a contiguous block of
+    // the nodes. First the threads lower the tentative distances with an atomic minimum, then they
+    // choose the first node in the order of nodes reaching the new distance as predecessor, like the
+    // serial relaxation does. Finally, the changes are applied and the criteria are notified in the
+    // order of the nodes: changed_predecessor for each improved destination of a node followed by
+    // relaxed_node. Only the final change of each destination is reported. The improved nodes are
+    // added to changed unless it is null.
+    // Phases with too few edges for two threads are relaxed serially. This leaves tentative above
+    // the distances in info, which is fine: only candidates below those distances are applied.
+    static void relax_parallel(const basic_graph<Node, Cost>& graph,
+                               const std::vector<Node>& nodes,
+                               node_map<dijkstra_result>& info,
+                               std::vector<std::atomic<Cost>>& tentative,
+                               std::vector<std::atomic<size_t>>& winner,
+                               CriteriaSet& criteria,
+                               fringe_queue* queue,
+                               todo_output* changed,
+                               size_t& fringe_size,
+                               size_t thread_count) {
+        size_t edge_count = 0;
+        for (Node node : nodes) {
+            edge_count += graph.outgoing_edges(node).size();
+        }
+        const size_t count = nodes.size();
+        const size_t threads = std::min({thread_count, count, edge_count / min_parallel_relax_edges});
+        if (threads <= 1) {
+            relax_serial(graph, nodes, info, criteria, queue, changed, fringe_size);
+            return;
+        }
+        auto block_begin = [&](size_t t) { return count * t / threads; };
+
+        parallel_for(threads, threads, [&](size_t t) {
+            for (size_t rank = block_begin(t); rank < block_begin(t + 1); ++rank) {
+                Cost distance = info[nodes[rank]].distance;
+                for (const auto& edge : graph.outgoing_edges(nodes[rank])) {
+                    if (info[edge.destination].settled()) {
+                        continue;
+                    }
+                    Cost candidate = distance + edge.cost;
+                    std::atomic<Cost>& target = tentative[edge.destination];
+                    Cost current = target.load(std::memory_order_relaxed);
+                    while (candidate < current &&
+                           !target.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                    }
+                }
+            }
+        });
+
+        // The improvements of each thread, (rank, destination) in the order of the nodes and edges.
+        std::vector<std::vector<std::pair<size_t, Node>>> improved(threads);
+        parallel_for(threads, threads, [&](size_t t) {
+            for (size_t rank = block_begin(t); rank < block_begin(t + 1); ++rank) {
+                Cost distance = info[nodes[rank]].distance;
+                for (const auto& edge : graph.outgoing_edges(nodes[rank])) {
+                    const auto& destination_node = info[edge.destination];
+                    Cost candidate = distance + edge.cost;
+                    if (destination_node.settled() || !(candidate < destination_node.distance) ||
+                        candidate != tentative[edge.destination].load(std::memory_order_relaxed)) {
+                        continue;
+                    }
+                    std::atomic<size_t>& target = winner[edge.destination];
+                    size_t current = target.load(std::memory_order_relaxed);
+                    while (rank < current && !target.compare_exchange_weak(current, rank, std::memory_order_relaxed)) {
+                    }
+                    improved[t].emplace_back(rank, edge.destination);
+                }
+            }
+        });
+
+        for (size_t t = 0; t < threads; ++t) {
+            auto change = improved[t].begin();
+            for (size_t rank = block_begin(t); rank < block_begin(t + 1); ++rank) {
+                const Node node = nodes[rank];
+                for (; change != improved[t].end() && change->first == rank; ++change) {
+                    const Node destination = change->second;
+                    if (winner[destination].load(std::memory_order_relaxed) != rank) {
+                        continue;
+                    }
+                    winner[destination].store(size_t(-1), std::memory_order_relaxed);
+                    auto& destination_node = info[destination];
+                    if (destination_node.unexplored()) {
+                        fringe_size += 1;
+                        BOOST_ASSERT(fringe_size <= graph.node_count());
+                    }
+                    destination_node.distance = tentative[destination].load(std::memory_order_relaxed);
+                    destination_node.predecessor = node;
+                    notify_changed(criteria, queue, destination, node, destination_node.distance);
+                    if (changed) {
+                        changed->insert(destination);
+                    }
+                }
+                notify_relaxed(criteria, queue, node);
+            }
+        }
+    }
+};
+
+// Like dijkstra() with a collection of criteria, but the types of the criteria are known at compile
+// time. The engine calls them without virtual dispatch.
+template <typename Node, typename Cost, typename... Criteria>
+node_map<basic_dijkstra_result<Node, Cost>> dijkstra(const basic_graph<Node, Cost>& graph,
+                                                     size_t start_node,
+                                                     std::tuple<Criteria...>& criteria,
+                                                     size_t thread_count = 1) {
+    static_criteria_set<Node, Cost, Criteria...> set(criteria);
+    return dijkstra_engine<Node, Cost, static_criteria_set<Node, Cost, Criteria...>>::run(
+        graph, start_node, set, thread_count);
+}
+
+} // namespace sssp
@@ -30,26 +30,29 @@ static void draw_edge(const Cairo::RefPtr<Cairo::Context>& cr,
     cr->restore();
 }
 
+template <typename Node, typename Cost>
 void sssp::draw_graph(const Cairo::RefPtr<Cairo::Context>& cr,
-                      const graph& graph,
+                      const basic_graph<Node, Cost>& graph,
                       const node_map<node_style>& node_styles,
                       const edge_map<edge_style>& edge_styles) {
     for (bool foreground : {false, true}) {
-        std::set<std::tuple<size_t, size_t>> drawn_edge_lines;
+        // The line of an edge is not drawn if the opposite edge has already been drawn. The nodes
+        // are visited in order, so only opposite edges from smaller nodes can have been drawn.
+        // drawn_line_to[n] == node marks that the line between n and node exists.
+        node_map<size_t> drawn_line_to(graph.node_count(), size_t(-1));
         for (size_t node = 0; node < graph.node_count(); ++node) {
-            for (const edge_info& edge : graph.outgoing_edges(node)) {
+            for (const basic_edge_info<Node, Cost>& edge : graph.incoming_edges(node)) {
+                if (edge.source < node && edge_styles[edge.index].foreground == foreground) {
+                    drawn_line_to[edge.source] = node;
+                }
+            }
 
-                const edge_style& edge_style = edge_styles.at({edge.source, edge.destination});
+            for (const basic_edge_info<Node, Cost>& edge : graph.outgoing_edges(node)) {
+                const edge_style& edge_style = edge_styles[edge.index];
                 if (edge_style.foreground == foreground) {
                     const node_style& source_style = node_styles[edge.source];
                     const node_style& destination_style = node_styles[edge.destination];
-                    draw_edge(cr,
-                              source_style,
-                              destination_style,
-                              edge_style,
-                              drawn_edge_lines.find({edge.source, edge.destination}) == drawn_edge_lines.end());
-                    drawn_edge_lines.emplace(edge.source, edge.destination);
-                    drawn_edge_lines.emplace(edge.destination, edge.source);
+                    draw_edge(cr, source_style, destination_style, edge_style, drawn_line_to[edge.destination] != node);
                 }
             }
         }
@@ -80,8 +83,8 @@ void sssp::draw_graph(const Cairo::RefPtr<Cairo::Context>& cr,
     cr->set_source_rgb(0.0, 0.0, 0.0);
     cr->set_font_size(0.0175);
     for (size_t node = 0; node < graph.node_count(); ++node) {
-        for (const edge_info& edge : graph.outgoing_edges(node)) {
-            const edge_style& edge_style = edge_styles.at({edge.source, edge.destination});
+        for (const basic_edge_info<Node, Cost>& edge : graph.outgoing_edges(node)) {
+            const edge_style& edge_style = edge_styles[edge.index];
             if (!edge_style.text.empty()) {
                 const node_style& source_style = node_styles[edge.source];
                 const node_style& destination_style = node_styles[edge.destination];
@@ -102,3 +105,10 @@ void sssp::draw_graph(const Cairo::RefPtr<Cairo::Context>& cr,
     }
     cr->restore();
 }
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template void sssp::draw_graph(const Cairo::RefPtr<Cairo::Context>&,                                               \
+                                   const basic_graph<NODE, COST>&,                                                     \
+                                   const node_map<node_style>&,                                                        \
+                                   const edge_map<edge_style>&);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
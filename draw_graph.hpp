@@ -19,8 +19,9 @@ struct edge_style {
 };
 
 // Draws the graph in the image area from 0/0 to 1/1.
+template <typename Node, typename Cost>
 void draw_graph(const Cairo::RefPtr<Cairo::Context>& cr,
-                const graph& graph,
+                const basic_graph<Node, Cost>& graph,
                 const node_map<node_style>& node_styles,
                 const edge_map<edge_style>& edge_styles);
 
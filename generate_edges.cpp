@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
+#include <numeric>
 #include <random>
 #include <unordered_set>
 
@@ -19,10 +20,11 @@ struct indexed_vec2 {
 
 BOOST_GEOMETRY_REGISTER_POINT_2D(indexed_vec2, double, boost::geometry::cs::cartesian, x, y)
 
+template <typename Node, typename Cost>
 void sssp::generate_uniform_edges(int seed,
                                   double edge_probability,
                                   const edge_cost_fn& edge_cost,
-                                  graph& graph,
+                                  basic_graph_builder<Node, Cost>& builder,
                                   const node_map<vec2>& positions) {
     std::mt19937 rng(seed);
 
@@ -30,19 +32,20 @@ void sssp::generate_uniform_edges(int seed,
     // This is the naive n*(n-1) steps algorithm. Each possible edge is considered
     // using a simple Bernulli(p) distribution.
     std::bernoulli_distribution allow_edge(edge_probability);
-    for (size_t source = 0; source < graph.node_count(); ++source) {
-        for (size_t destination = 0; destination < graph.node_count(); ++destination) {
+    for (size_t source = 0; source < builder.node_count(); ++source) {
+        for (size_t destination = 0; destination < builder.node_count(); ++destination) {
             if (destination != source && allow_edge(rng)) {
-                graph.add_edge(source, destination, edge_cost(line(positions[source], positions[destination])));
+                builder.add_edge(source, destination, edge_cost(line(positions[source], positions[destination])));
             }
         }
     }
 #else
     // An more efficient variant is to draw for each node k ~ Binom(n-1, p), and then
     // generate edges to k random other nodes.
-    std::binomial_distribution<size_t> edge_count_dist(graph.node_count() - 1, edge_probability);
-    node_map<size_t> destinations = graph.make_node_map([](size_t i) { return i; });
-    for (size_t source = 0; source < graph.node_count(); ++source) {
+    std::binomial_distribution<size_t> edge_count_dist(builder.node_count() - 1, edge_probability);
+    node_map<size_t> destinations(builder.node_count());
+    std::iota(destinations.begin(), destinations.end(), 0);
+    for (size_t source = 0; source < builder.node_count(); ++source) {
         size_t edge_count = edge_count_dist(rng);
         partial_shuffle(destinations.begin(), destinations.begin() + edge_count + 1, destinations.end(), rng);
         for (size_t i = 0; i < edge_count; ++i) {
@@ -54,21 +57,22 @@ void sssp::generate_uniform_edges(int seed,
             } else {
                 destination = destinations[i];
             }
-            graph.add_edge(source, destination, edge_cost(line(positions[source], positions[destination])));
+            builder.add_edge(source, destination, edge_cost(line(positions[source], positions[destination])));
         }
     }
 #endif
 }
 
+template <typename Node, typename Cost>
 void sssp::generate_planar_edges(int seed,
                                  double edge_probability,
                                  const edge_cost_fn& edge_cost,
-                                 graph& graph,
+                                 basic_graph_builder<Node, Cost>& builder,
                                  const node_map<vec2>& positions) {
     using namespace boost::geometry;
 
     std::mt19937 rng(seed);
-    std::binomial_distribution<size_t> edge_count_dist(graph.node_count() - 1, edge_probability);
+    std::binomial_distribution<size_t> edge_count_dist(builder.node_count() - 1, edge_probability);
 
     boost::geometry::index::rtree<indexed_vec2, index::quadratic<16>> points;
     for (size_t i = 0; i < positions.size(); ++i) {
@@ -78,7 +82,7 @@ void sssp::generate_planar_edges(int seed,
     boost::geometry::index::rtree<line, index::quadratic<16>> lines;
     std::vector<indexed_vec2> result;
 
-    for (size_t source = 0; source < graph.node_count(); ++source) {
+    for (size_t source = 0; source < builder.node_count(); ++source) {
         int edge_count = static_cast<int>(edge_count_dist(rng));
         if (edge_count > 0) {
             result.clear();
@@ -101,7 +105,7 @@ void sssp::generate_planar_edges(int seed,
                 };
                 if (lines.qbegin(index::intersects(candidate) && index::satisfies(line_endings_unequal)) ==
                     lines.qend()) {
-                    graph.add_edge(source, dest.index, edge_cost(candidate));
+                    builder.add_edge(source, dest.index, edge_cost(candidate));
                     lines.insert(candidate);
                     done += 1;
                 }
@@ -117,20 +121,21 @@ int sssp::y_bucket(int layers, double y) {
     return std::min(static_cast<int>(std::floor(y * layers)), layers - 1);
 }
 
+template <typename Node, typename Cost>
 void sssp::generate_layered_edges(int seed,
                                   double edge_probability,
                                   int layers,
                                   const edge_cost_fn& edge_cost,
-                                  graph& graph,
+                                  basic_graph_builder<Node, Cost>& builder,
                                   const node_map<vec2>& positions) {
     std::mt19937 rng(seed);
 
     std::vector<std::vector<size_t>> buckets(layers);
-    for (size_t n = 0; n < graph.node_count(); ++n) {
+    for (size_t n = 0; n < builder.node_count(); ++n) {
         buckets[y_bucket(layers, positions[n].y)].emplace_back(n);
     }
 
-    for (size_t source = 0; source < graph.node_count(); ++source) {
+    for (size_t source = 0; source < builder.node_count(); ++source) {
         std::vector<size_t> destinations;
         int source_bucket = y_bucket(layers, positions[source].y);
         if (source_bucket > 0) {
@@ -144,16 +149,17 @@ void sssp::generate_layered_edges(int seed,
         size_t edge_count = std::binomial_distribution<size_t>(destinations.size(), edge_probability)(rng);
         partial_shuffle(destinations.begin(), destinations.begin() + edge_count, destinations.end(), rng);
         for (size_t i = 0; i < edge_count; ++i) {
-            graph.add_edge(source, destinations[i], edge_cost(line(positions[source], positions[destinations[i]])));
+            builder.add_edge(source, destinations[i], edge_cost(line(positions[source], positions[destinations[i]])));
         }
     }
 }
 
+template <typename Node, typename Cost>
 void sssp::generate_kronecker_graph(int seed,
                                     std::vector<double> matrix,
                                     int k,
                                     const edge_cost_fn& edge_cost,
-                                    graph& graph,
+                                    basic_graph_builder<Node, Cost>& builder,
                                     node_map<vec2>& positions) {
     std::mt19937 rng(seed);
 
@@ -169,9 +175,7 @@ void sssp::generate_kronecker_graph(int seed,
     }
 
     positions.resize(final_size, vec2(0.0, 0.0));
-    for (size_t n = 0; n < final_size; ++n) {
-        graph.add_node();
-    }
+    builder.add_nodes(final_size);
 
     std::vector<double> matrix_prefix_sum(matrix.size());
     matrix_prefix_sum[0] = matrix[0];
@@ -189,6 +193,7 @@ void sssp::generate_kronecker_graph(int seed,
     // the probabilites are very low (this is given here due to the nature of potentiation of lots of
     // probabilities).
     size_t edges = std::poisson_distribution<size_t>(edges_expected_value)(rng);
+    builder.reserve_edges(edges);
 
     std::uniform_real_distribution<double> cell_dist(0.0, matrix_prefix_sum.back());
     std::unordered_set<size_t> used_cells;
@@ -223,6 +228,17 @@ void sssp::generate_kronecker_graph(int seed,
         }
         tries = 0;
         used_cells.insert(cell);
-        graph.add_edge(u, v, edge_cost(line(vec2(0.0, 0.0), vec2(0.0, 0.0))));
+        builder.add_edge(u, v, edge_cost(line(vec2(0.0, 0.0), vec2(0.0, 0.0))));
     }
 }
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template void sssp::generate_uniform_edges(                                                                        \
+        int, double, const edge_cost_fn&, basic_graph_builder<NODE, COST>&, const node_map<vec2>&);                    \
+    template void sssp::generate_planar_edges(                                                                         \
+        int, double, const edge_cost_fn&, basic_graph_builder<NODE, COST>&, const node_map<vec2>&);                    \
+    template void sssp::generate_layered_edges(                                                                        \
+        int, double, int, const edge_cost_fn&, basic_graph_builder<NODE, COST>&, const node_map<vec2>&);               \
+    template void sssp::generate_kronecker_graph(                                                                      \
+        int, std::vector<double>, int, const edge_cost_fn&, basic_graph_builder<NODE, COST>&, node_map<vec2>&);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
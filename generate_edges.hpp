@@ -8,41 +8,45 @@ namespace sssp {
 using edge_cost_fn = std::function<double(const line&)>;
 
 // Generates uniformly random edges. The positions are irrelevant and only used for the cost callback.
+template <typename Node, typename Cost>
 void generate_uniform_edges(int seed,
                             double edge_probability,
                             const edge_cost_fn& edge_cost,
-                            graph& graph,
+                            basic_graph_builder<Node, Cost>& builder,
                             const node_map<vec2>& positions);
 
 // Generates edges that do not intersect each other. The max_edge_length parameter is the radius
 // that is considered for creating edges and edge_probability is the chance that a possible edge
 // is chosen.
+template <typename Node, typename Cost>
 void generate_planar_edges(int seed,
                            double edge_probability,
                            const edge_cost_fn& edge_cost,
-                           graph& graph,
+                           basic_graph_builder<Node, Cost>& builder,
                            const node_map<vec2>& positions);
 
 // Creates graphs that can only be connected like that: 1 <-> 2 <-> 3 ...
 // with 1, 2, 3 ... being the layers.
+template <typename Node, typename Cost>
 void generate_layered_edges(int seed,
                             double edge_probability,
                             int layers,
                             const edge_cost_fn& edge_cost,
-                            graph& graph,
+                            basic_graph_builder<Node, Cost>& builder,
                             const node_map<vec2>& positions);
 
 // Returns the layer of a graph along the y-axis.
 int y_bucket(int layers, double y);
 
 // Creates a Kronecker graph. Different to the other functions, this function also creates the nodes
-// in the graph and fills the positions node_map with all zeros. Note that this implements
+// in the builder and fills the positions node_map with all zeros. Note that this implements
 // the stochastic version of the algorithm.
+template <typename Node, typename Cost>
 void generate_kronecker_graph(int seed,
                               std::vector<double> matrix,
                               int k,
                               const edge_cost_fn& edge_cost,
-                              graph& graph,
+                              basic_graph_builder<Node, Cost>& builder,
                               node_map<vec2>& positions);
 
 } // namespace sssp
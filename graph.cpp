@@ -1,39 +1,413 @@
 #include "graph.hpp"
+#include "dijkstra.hpp"
+#include "graph_index.hpp"
+#include "parallel.hpp"
 #include <algorithm>
 #include <boost/assert.hpp>
+#include <limits>
+#include <numeric>
+#include <tuple>
 
-sssp::graph::graph() {}
+// Returns the index of the first edge of each node in the sorted edge list, followed by the edge count.
+template <typename Edge>
+static std::vector<size_t> source_offsets(const std::vector<Edge>& edges, size_t node_count, size_t threads) {
+    std::vector<size_t> offsets(node_count + 1);
+    sssp::parallel_for(node_count, threads, [&](size_t node) {
+        auto first =
+            std::lower_bound(edges.begin(), edges.end(), node, [](const Edge& e, size_t n) { return e.source < n; });
+        offsets[node] = std::distance(edges.begin(), first);
+    });
+    offsets[node_count] = edges.size();
+    return offsets;
+}
+
+// Returns the number of bytes read_varint needs for the value.
+static size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7) {
+        ++size;
+    }
+    return size;
+}
+
+// Writes the value for read_varint and returns the position behind it.
+static uint8_t* write_varint(uint64_t value, uint8_t* bytes) {
+    for (; value >= 0x80; value >>= 7) {
+        *bytes++ = static_cast<uint8_t>(value | 0x80);
+    }
+    *bytes++ = static_cast<uint8_t>(value);
+    return bytes;
+}
+
+// Calls emit with the values basic_edge_iterator::decode reads for the edges begin to end of a node.
+// other(i) returns the other node of the i-th edge, which have to be ascending, and position(i) the
+// position of the edge in the outgoing edges of its source, which is only stored for incoming edges.
+template <bool Incoming, typename Other, typename Position, typename Emit>
+static void
+encode_edges(size_t node, size_t begin, size_t end, const Other& other, const Position& position, const Emit& emit) {
+    for (size_t i = begin; i < end; ++i) {
+        if (i == begin) {
+            int64_t difference = static_cast<int64_t>(other(i)) - static_cast<int64_t>(node);
+            emit((static_cast<uint64_t>(difference) << 1) ^ static_cast<uint64_t>(difference >> 63));
+        } else {
+            BOOST_ASSERT(other(i) > other(i - 1));
+            emit(other(i) - other(i - 1) - 1);
+        }
+        if (Incoming) {
+            emit(position(i));
+        }
+    }
+}
+
+// Encodes the edges of all nodes with encode(node, emit) in parallel. The first pass only sums up
+// the sizes, the second one writes the bytes.
+template <typename Encode>
+static void encode_nodes(size_t node_count,
+                         size_t threads,
+                         const Encode& encode,
+                         std::vector<size_t>& byte_offsets,
+                         std::vector<uint8_t>& bytes) {
+    byte_offsets.assign(node_count + 1, 0);
+    sssp::parallel_for(node_count, threads, [&](size_t node) {
+        size_t size = 0;
+        encode(node, [&](uint64_t value) { size += varint_size(value); });
+        byte_offsets[node + 1] = size;
+    });
+    std::partial_sum(byte_offsets.begin(), byte_offsets.end(), byte_offsets.begin());
+    bytes.resize(byte_offsets[node_count]);
+    sssp::parallel_for(node_count, threads, [&](size_t node) {
+        uint8_t* out = bytes.data() + byte_offsets[node];
+        encode(node, [&](uint64_t value) { out = write_varint(value, out); });
+        BOOST_ASSERT(out == bytes.data() + byte_offsets[node + 1]);
+    });
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost>::basic_graph() : m_compressed(false), m_cache(std::make_shared<shared_cache>()) {
+    static const size_t empty_offsets[1] = {0};
+    m_arrays = arrays{0, 0, empty_offsets, nullptr, nullptr, empty_offsets, nullptr, nullptr, nullptr};
+    m_compressed_arrays = compressed_arrays{nullptr, nullptr, nullptr, nullptr, nullptr};
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost>::basic_graph(const arrays& arrays, std::shared_ptr<const void> keep_alive)
+    : m_arrays(arrays), m_compressed(false), m_compressed_arrays{nullptr, nullptr, nullptr, nullptr, nullptr},
+      m_keep_alive(std::move(keep_alive)), m_cache(std::make_shared<shared_cache>()) {}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost>::basic_graph(const arrays& arrays,
+                                           const compressed_arrays& compressed,
+                                           std::shared_ptr<const void> keep_alive)
+    : m_arrays(arrays), m_compressed(true), m_compressed_arrays(compressed), m_keep_alive(std::move(keep_alive)),
+      m_cache(std::make_shared<shared_cache>()) {}
+
+template <typename Node, typename Cost>
+size_t sssp::basic_graph<Node, Cost>::node_count() const {
+    return m_arrays.node_count;
+}
+
+template <typename Node, typename Cost>
+size_t sssp::basic_graph<Node, Cost>::edge_count() const {
+    return m_arrays.edge_count;
+}
+
+template <typename Node, typename Cost>
+size_t sssp::basic_graph<Node, Cost>::storage_size() const {
+    size_t offsets = 2 * (node_count() + 1) * sizeof(size_t);
+    if (m_compressed) {
+        return 2 * offsets + m_compressed_arrays.outgoing_byte_offsets[node_count()] +
+               m_compressed_arrays.incoming_byte_offsets[node_count()] + edge_count() * sizeof(Cost);
+    } else {
+        return offsets + edge_count() * (2 * sizeof(Node) + 2 * sizeof(Cost) + sizeof(size_t));
+    }
+}
+
+template <typename Node, typename Cost>
+const sssp::basic_graph_index<Node, Cost>& sssp::basic_graph<Node, Cost>::index() const {
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    if (!m_cache->index) {
+        m_cache->index = std::make_shared<basic_graph_index<Node, Cost>>(*this);
+    }
+    return *m_cache->index;
+}
+
+template <typename Node, typename Cost>
+const sssp::node_map<Cost>& sssp::basic_graph<Node, Cost>::reference_distances(size_t start_node) const {
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    std::shared_ptr<const node_map<Cost>>& distances = m_cache->distances[start_node];
+    if (!distances) {
+        distances = std::make_shared<node_map<Cost>>(shortest_distances(*this, start_node));
+    }
+    return *distances;
+}
+
+template <typename Node, typename Cost>
+auto sssp::basic_graph<Node, Cost>::outgoing_edges(Node source) const -> edge_range {
+    using iterator = typename edge_range::iterator;
+    size_t begin = m_arrays.outgoing_offsets[source];
+    size_t end = m_arrays.outgoing_offsets[source + 1];
+    if (m_compressed) {
+        const uint8_t* bytes =
+            m_compressed_arrays.outgoing_bytes + m_compressed_arrays.outgoing_byte_offsets[source];
+        const Cost* costs = m_compressed_arrays.costs;
+        return edge_range(iterator(source, bytes, costs, nullptr, begin, begin, end),
+                          iterator(source, bytes, costs, nullptr, begin, end, end));
+    }
+    return edge_range(iterator(source, m_arrays.outgoing_destinations, m_arrays.outgoing_costs, nullptr, begin),
+                      iterator(source, m_arrays.outgoing_destinations, m_arrays.outgoing_costs, nullptr, end));
+}
 
-size_t sssp::graph::add_node() {
-    size_t index = m_nodes.size();
-    m_nodes.emplace_back();
+template <typename Node, typename Cost>
+auto sssp::basic_graph<Node, Cost>::incoming_edges(Node destination) const -> edge_range {
+    using iterator = typename edge_range::iterator;
+    size_t begin = m_arrays.incoming_offsets[destination];
+    size_t end = m_arrays.incoming_offsets[destination + 1];
+    if (m_compressed) {
+        const uint8_t* bytes =
+            m_compressed_arrays.incoming_bytes + m_compressed_arrays.incoming_byte_offsets[destination];
+        const Cost* costs = m_compressed_arrays.costs;
+        const size_t* offsets = m_arrays.outgoing_offsets;
+        return edge_range(iterator(destination, bytes, costs, offsets, 0, begin, end),
+                          iterator(destination, bytes, costs, offsets, 0, end, end));
+    }
+    return edge_range(
+        iterator(
+            destination, m_arrays.incoming_sources, m_arrays.incoming_costs, m_arrays.incoming_edge_indices, begin),
+        iterator(destination, m_arrays.incoming_sources, m_arrays.incoming_costs, m_arrays.incoming_edge_indices, end));
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph_builder<Node, Cost>::basic_graph_builder() {}
+
+template <typename Node, typename Cost>
+Node sssp::basic_graph_builder<Node, Cost>::add_node() {
+    return add_nodes(1);
+}
+
+template <typename Node, typename Cost>
+Node sssp::basic_graph_builder<Node, Cost>::add_nodes(size_t count) {
+    BOOST_ASSERT(can_index(m_node_count + count));
+    Node index = static_cast<Node>(m_node_count);
+    m_node_count += count;
     return index;
 }
 
-void sssp::graph::add_edge(size_t source, size_t destination, double cost) {
-    BOOST_ASSERT(
-        std::find_if(m_nodes[source].outgoing.begin(), m_nodes[source].outgoing.end(), [&](const edge_info& e) {
-            return e.destination == destination;
-        }) == m_nodes[source].outgoing.end());
-    BOOST_ASSERT(std::find_if(m_nodes[destination].incoming.begin(),
-                              m_nodes[destination].incoming.end(),
-                              [&](const edge_info& e) { return e.source == source; }) ==
-                 m_nodes[destination].incoming.end());
-    BOOST_ASSERT(source != destination);
-    BOOST_ASSERT(cost >= 0.0);
-    m_nodes[source].outgoing.push_back(edge_info(source, destination, cost));
-    m_nodes[destination].incoming.push_back(edge_info(source, destination, cost));
-    m_edge_count += 1;
+template <typename Node, typename Cost>
+void sssp::basic_graph_builder<Node, Cost>::add_edge(Node source, Node destination, Cost cost) {
+    BOOST_ASSERT(source < m_node_count);
+    BOOST_ASSERT(destination < m_node_count);
+    BOOST_ASSERT(cost >= Cost(0));
+    m_edges.emplace_back(source, destination, cost);
+}
+
+template <typename Node, typename Cost>
+void sssp::basic_graph_builder<Node, Cost>::add_edges(const std::vector<edge_info>& edges) {
+    m_edges.reserve(m_edges.size() + edges.size());
+    for (const edge_info& edge : edges) {
+        add_edge(edge.source, edge.destination, edge.cost);
+    }
 }
 
-size_t sssp::graph::node_count() const {
-    return m_nodes.size();
+template <typename Node, typename Cost>
+void sssp::basic_graph_builder<Node, Cost>::reserve_edges(size_t edge_count) {
+    m_edges.reserve(edge_count);
 }
 
-const std::vector<sssp::edge_info>& sssp::graph::outgoing_edges(size_t source) const {
-    return m_nodes[source].outgoing;
+template <typename Node, typename Cost>
+size_t sssp::basic_graph_builder<Node, Cost>::node_count() const {
+    return m_node_count;
 }
 
-const std::vector<sssp::edge_info>& sssp::graph::incoming_edges(size_t destination) const {
-    return m_nodes[destination].incoming;
+template <typename Node, typename Cost>
+bool sssp::basic_graph_builder<Node, Cost>::can_index(size_t node_count) {
+    // Node(-1) is reserved as "no node".
+    return node_count < static_cast<size_t>(std::numeric_limits<Node>::max());
 }
+
+template <typename Node, typename Cost> void sssp::basic_graph_builder<Node, Cost>::sort_edges() {
+    // After sorting, parallel edges are next to each other with the cheapest one first.
+    parallel_sort(
+        m_edges.begin(),
+        m_edges.end(),
+        [](const edge_info& a, const edge_info& b) {
+            return std::tie(a.source, a.destination, a.cost) < std::tie(b.source, b.destination, b.cost);
+        },
+        default_thread_count());
+    auto edges_end = std::unique(m_edges.begin(), m_edges.end(), [](const edge_info& a, const edge_info& b) {
+        return a.source == b.source && a.destination == b.destination;
+    });
+    edges_end = std::remove_if(
+        m_edges.begin(), edges_end, [](const edge_info& edge) { return edge.source == edge.destination; });
+    m_edges.erase(edges_end, m_edges.end());
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost> sssp::basic_graph_builder<Node, Cost>::build() {
+    size_t threads = default_thread_count();
+    sort_edges();
+    size_t edge_count = m_edges.size();
+
+    // The arrays of the graph, owned by the graph once it is built.
+    struct storage {
+        std::vector<size_t> outgoing_offsets;
+        std::vector<Node> outgoing_destinations;
+        std::vector<Cost> outgoing_costs;
+        std::vector<size_t> incoming_offsets;
+        std::vector<Node> incoming_sources;
+        std::vector<Cost> incoming_costs;
+        std::vector<size_t> incoming_edge_indices;
+    };
+    auto result = std::make_shared<storage>();
+    result->incoming_offsets.assign(m_node_count + 1, 0);
+    result->outgoing_destinations.resize(edge_count);
+    result->outgoing_costs.resize(edge_count);
+    result->incoming_sources.resize(edge_count);
+    result->incoming_costs.resize(edge_count);
+    result->incoming_edge_indices.resize(edge_count);
+
+    // The edge list is in the order of the outgoing arrays already, so the position in the
+    // edge list is the edge index.
+    parallel_blocks(edge_count, threads, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e) {
+            result->outgoing_destinations[e] = m_edges[e].destination;
+            result->outgoing_costs[e] = m_edges[e].cost;
+        }
+    });
+    result->outgoing_offsets = source_offsets(m_edges, m_node_count, threads);
+
+    // The incoming arrays are filled with a counting sort by destination. It is stable and
+    // therefore keeps the incoming edges sorted by source.
+    for (const edge_info& edge : m_edges) {
+        result->incoming_offsets[edge.destination + 1] += 1;
+    }
+    std::partial_sum(
+        result->incoming_offsets.begin(), result->incoming_offsets.end(), result->incoming_offsets.begin());
+    std::vector<size_t> incoming_at(result->incoming_offsets.begin(), result->incoming_offsets.end() - 1);
+    for (size_t e = 0; e < edge_count; ++e) {
+        const edge_info& edge = m_edges[e];
+        size_t in = incoming_at[edge.destination]++;
+        result->incoming_sources[in] = edge.source;
+        result->incoming_costs[in] = edge.cost;
+        result->incoming_edge_indices[in] = e;
+    }
+
+    typename basic_graph<Node, Cost>::arrays arrays{m_node_count,
+                                                    edge_count,
+                                                    result->outgoing_offsets.data(),
+                                                    result->outgoing_destinations.data(),
+                                                    result->outgoing_costs.data(),
+                                                    result->incoming_offsets.data(),
+                                                    result->incoming_sources.data(),
+                                                    result->incoming_costs.data(),
+                                                    result->incoming_edge_indices.data()};
+    return basic_graph<Node, Cost>(arrays, std::move(result));
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost> sssp::basic_graph_builder<Node, Cost>::build_compressed() {
+    size_t threads = default_thread_count();
+    sort_edges();
+    size_t edge_count = m_edges.size();
+
+    // The arrays of the graph, owned by the graph once it is built.
+    struct storage {
+        std::vector<size_t> outgoing_offsets;
+        std::vector<size_t> incoming_offsets;
+        std::vector<size_t> outgoing_byte_offsets;
+        std::vector<uint8_t> outgoing_bytes;
+        std::vector<size_t> incoming_byte_offsets;
+        std::vector<uint8_t> incoming_bytes;
+        std::vector<Cost> costs;
+    };
+    auto result = std::make_shared<storage>();
+    result->outgoing_offsets = source_offsets(m_edges, m_node_count, threads);
+    result->costs.resize(edge_count);
+    parallel_blocks(edge_count, threads, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e) {
+            result->costs[e] = m_edges[e].cost;
+        }
+    });
+
+    const std::vector<size_t>& outgoing_offsets = result->outgoing_offsets;
+    encode_nodes(
+        m_node_count,
+        threads,
+        [&](size_t node, const auto& emit) {
+            encode_edges<false>(
+                node,
+                outgoing_offsets[node],
+                outgoing_offsets[node + 1],
+                [&](size_t e) { return m_edges[e].destination; },
+                [](size_t) { return 0; },
+                emit);
+        },
+        result->outgoing_byte_offsets,
+        result->outgoing_bytes);
+
+    // The edge indices sorted by destination with a counting sort. It is stable and therefore
+    // keeps the incoming edges sorted by source.
+    result->incoming_offsets.assign(m_node_count + 1, 0);
+    for (const edge_info& edge : m_edges) {
+        result->incoming_offsets[edge.destination + 1] += 1;
+    }
+    std::partial_sum(
+        result->incoming_offsets.begin(), result->incoming_offsets.end(), result->incoming_offsets.begin());
+    std::vector<size_t> incoming(edge_count);
+    std::vector<size_t> incoming_at(result->incoming_offsets.begin(), result->incoming_offsets.end() - 1);
+    for (size_t e = 0; e < edge_count; ++e) {
+        incoming[incoming_at[m_edges[e].destination]++] = e;
+    }
+    incoming_at = std::vector<size_t>();
+
+    const std::vector<size_t>& incoming_offsets = result->incoming_offsets;
+    encode_nodes(
+        m_node_count,
+        threads,
+        [&](size_t node, const auto& emit) {
+            encode_edges<true>(
+                node,
+                incoming_offsets[node],
+                incoming_offsets[node + 1],
+                [&](size_t i) { return m_edges[incoming[i]].source; },
+                [&](size_t i) { return incoming[i] - outgoing_offsets[m_edges[incoming[i]].source]; },
+                emit);
+        },
+        result->incoming_byte_offsets,
+        result->incoming_bytes);
+
+    typename basic_graph<Node, Cost>::arrays arrays{m_node_count,
+                                                    edge_count,
+                                                    result->outgoing_offsets.data(),
+                                                    nullptr,
+                                                    nullptr,
+                                                    result->incoming_offsets.data(),
+                                                    nullptr,
+                                                    nullptr,
+                                                    nullptr};
+    typename basic_graph<Node, Cost>::compressed_arrays compressed{result->outgoing_byte_offsets.data(),
+                                                                   result->outgoing_bytes.data(),
+                                                                   result->incoming_byte_offsets.data(),
+                                                                   result->incoming_bytes.data(),
+                                                                   result->costs.data()};
+    return basic_graph<Node, Cost>(arrays, compressed, std::move(result));
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost> sssp::compress_graph(const basic_graph<Node, Cost>& graph) {
+    basic_graph_builder<Node, Cost> builder;
+    builder.add_nodes(graph.node_count());
+    builder.reserve_edges(graph.edge_count());
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        for (const auto& edge : graph.outgoing_edges(static_cast<Node>(node))) {
+            builder.add_edge(edge.source, edge.destination, edge.cost);
+        }
+    }
+    // The edges are sorted already, so they keep their indices.
+    return builder.build_compressed();
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template class sssp::basic_graph<NODE, COST>;                                                                      \
+    template class sssp::basic_graph_builder<NODE, COST>;                                                              \
+    template sssp::basic_graph<NODE, COST> sssp::compress_graph(const basic_graph<NODE, COST>&);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
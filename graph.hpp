@@ -1,115 +1,351 @@
 #pragma once
-#include <boost/functional/hash.hpp>
+#include <boost/assert.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <cstdint>
-#include <deque>
-#include <unordered_map>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Calls X(Node, Cost) for each combination of node index type and edge cost type the graph,
+// dijkstra() and the criteria are instantiated for. The first one is the default.
+#define SSSP_FOR_EACH_GRAPH_TYPE(X) X(size_t, double) X(size_t, float) X(uint32_t, double) X(uint32_t, float)
 
 namespace sssp {
 
-struct edge_info {
-    edge_info(size_t source, size_t destination, double cost) : source(source), destination(destination), cost(cost) {}
-    size_t source;
-    size_t destination;
-    double cost;
+template <typename Node, typename Cost> struct basic_edge_info {
+    basic_edge_info(Node source, Node destination, Cost cost) : basic_edge_info(source, destination, cost, -1) {}
+    basic_edge_info(Node source, Node destination, Cost cost, size_t index)
+        : source(source), destination(destination), cost(cost), index(index) {}
+    Node source;
+    Node destination;
+    Cost cost;
+    // The dense index of the edge in its graph, see edge_map. size_t(-1) if it is not part of a graph.
+    size_t index;
 };
 
 template <typename T> using node_map = std::vector<T>;
 
-struct edge_id {
-    edge_id(size_t source, size_t destination) : source(source), destination(destination) {}
-    size_t source;
-    size_t destination;
-};
+// Every edge of a graph has a stable index from 0 to edge_count - 1. The edges are numbered
+// by their source node and then by their position in the outgoing edges of the source.
+template <typename T> using edge_map = std::vector<T>;
 
-inline bool operator==(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) == std::tie(b.source, b.destination);
+// Reads an unsigned LEB128 variable length integer and advances bytes behind it. Compressed graphs
+// store their neighbour lists with it, see basic_graph::compressed_arrays.
+inline uint64_t read_varint(const uint8_t*& bytes) {
+    uint64_t value = *bytes & 0x7f;
+    for (int shift = 7; *bytes++ & 0x80; shift += 7) {
+        value |= uint64_t(*bytes & 0x7f) << shift;
+    }
+    return value;
 }
 
-inline bool operator!=(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) != std::tie(b.source, b.destination);
-}
+// Iterates the edges of a single node, see basic_edge_range. In compressed graphs the edges are
+// decoded one after the other, so the iterator cannot move backwards and advancing it by n
+// takes linear time.
+template <typename Node, typename Cost>
+class basic_edge_iterator : public boost::iterator_facade<basic_edge_iterator<Node, Cost>,
+                                                          basic_edge_info<Node, Cost>,
+                                                          boost::random_access_traversal_tag,
+                                                          basic_edge_info<Node, Cost>> {
+  public:
+    basic_edge_iterator()
+        : m_node(0), m_other_nodes(nullptr), m_costs(nullptr), m_edge_indices(nullptr), m_position(0),
+          m_compressed(false), m_bytes(nullptr), m_outgoing_offsets(nullptr), m_end(0), m_other_node(0), m_index(0) {}
 
-inline bool operator<(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) < std::tie(b.source, b.destination);
-}
+    // Iterator into the arrays of a graph stored as plain CSR. edge_indices maps the positions to
+    // edge indices and is nullptr for outgoing edges.
+    basic_edge_iterator(
+        Node node, const Node* other_nodes, const Cost* costs, const size_t* edge_indices, size_t position)
+        : m_node(node), m_other_nodes(other_nodes), m_costs(costs), m_edge_indices(edge_indices),
+          m_position(position), m_compressed(false), m_bytes(nullptr), m_outgoing_offsets(nullptr), m_end(0),
+          m_other_node(0), m_index(0) {}
 
-inline bool operator<=(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) <= std::tie(b.source, b.destination);
-}
+    // Iterator decoding the bytes of a node in a compressed graph, starting at position. costs is
+    // indexed by edge index. For outgoing edges first_index is the index of the first edge and
+    // outgoing_offsets nullptr, for incoming edges outgoing_offsets are the edge offsets of the graph.
+    basic_edge_iterator(Node node,
+                        const uint8_t* bytes,
+                        const Cost* costs,
+                        const size_t* outgoing_offsets,
+                        size_t first_index,
+                        size_t position,
+                        size_t end)
+        : m_node(node), m_other_nodes(nullptr), m_costs(costs), m_edge_indices(nullptr), m_position(position),
+          m_compressed(true), m_bytes(bytes), m_outgoing_offsets(outgoing_offsets), m_end(end), m_other_node(0),
+          m_index(first_index) {
+        if (m_position < m_end) {
+            decode(true);
+        }
+    }
 
-inline bool operator>(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) > std::tie(b.source, b.destination);
-}
+  private:
+    friend class boost::iterator_core_access;
 
-inline bool operator>=(const edge_id& a, const edge_id& b) {
-    return std::tie(a.source, a.destination) >= std::tie(b.source, b.destination);
-}
+    basic_edge_info<Node, Cost> dereference() const {
+        if (m_compressed) {
+            if (m_outgoing_offsets == nullptr) {
+                return basic_edge_info<Node, Cost>(m_node, m_other_node, m_costs[m_index], m_index);
+            } else {
+                return basic_edge_info<Node, Cost>(m_other_node, m_node, m_costs[m_index], m_index);
+            }
+        } else if (m_edge_indices == nullptr) {
+            // Outgoing edges are stored in index order.
+            return basic_edge_info<Node, Cost>(m_node, m_other_nodes[m_position], m_costs[m_position], m_position);
+        } else {
+            return basic_edge_info<Node, Cost>(
+                m_other_nodes[m_position], m_node, m_costs[m_position], m_edge_indices[m_position]);
+        }
+    }
+    bool equal(const basic_edge_iterator& other) const { return m_position == other.m_position; }
+    void increment() {
+        ++m_position;
+        if (m_compressed && m_position < m_end) {
+            decode(false);
+        }
+    }
+    void decrement() {
+        BOOST_ASSERT(!m_compressed);
+        --m_position;
+    }
+    void advance(std::ptrdiff_t n) {
+        if (m_compressed) {
+            BOOST_ASSERT(n >= 0);
+            for (; n > 0; --n) {
+                increment();
+            }
+        } else {
+            m_position += n;
+        }
+    }
+    std::ptrdiff_t distance_to(const basic_edge_iterator& other) const {
+        return static_cast<std::ptrdiff_t>(other.m_position) - static_cast<std::ptrdiff_t>(m_position);
+    }
+
+    // Decodes the edge at m_position. The first other node is stored as zigzag encoded difference
+    // to the node itself, the others as the gap to the previous one minus one. Incoming edges store
+    // the position of the edge in the outgoing edges of its source after the node.
+    void decode(bool first) {
+        uint64_t value = read_varint(m_bytes);
+        if (first) {
+            int64_t difference = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            m_other_node = static_cast<Node>(static_cast<int64_t>(m_node) + difference);
+        } else {
+            m_other_node = static_cast<Node>(m_other_node + value + 1);
+        }
+        if (m_outgoing_offsets == nullptr) {
+            m_index += first ? 0 : 1;
+        } else {
+            m_index = m_outgoing_offsets[m_other_node] + read_varint(m_bytes);
+        }
+    }
+
+    Node m_node;
+    const Node* m_other_nodes;
+    const Cost* m_costs;
+    const size_t* m_edge_indices;
+    size_t m_position;
 
-template <typename T> using edge_map = std::unordered_map<edge_id, T>;
+    // Only used for compressed graphs, m_other_node and m_index describe the edge at m_position.
+    bool m_compressed;
+    const uint8_t* m_bytes;
+    const size_t* m_outgoing_offsets;
+    size_t m_end;
+    Node m_other_node;
+    size_t m_index;
+};
 
-// A directed graph. This datastructure is designed to be very flexible, but still
-// tries to be very performant.
-class graph {
+// The edges of a single node, i.e., a view into the packed arrays of a graph. The
+// node is the source of all outgoing and the destination of all incoming edges,
+// therefore only the other end of each edge is stored.
+template <typename Node, typename Cost> class basic_edge_range {
   public:
+    using iterator = basic_edge_iterator<Node, Cost>;
+
+    basic_edge_range(iterator begin, iterator end) : m_begin(begin), m_end(end) {}
+
+    iterator begin() const { return m_begin; }
+    iterator end() const { return m_end; }
+    size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_end == m_begin; }
+
+    basic_edge_info<Node, Cost> operator[](size_t i) const { return begin()[i]; }
+    basic_edge_info<Node, Cost> front() const { return (*this)[0]; }
+    basic_edge_info<Node, Cost> back() const { return (*this)[size() - 1]; }
+
+  private:
+    iterator m_begin;
+    iterator m_end;
+};
+
+// A directed graph stored as compressed sparse rows (CSR). The graph is immutable,
+// use the graph_builder to create one or load one with read_binary_graph. The outgoing and the incoming edges are both
+// stored as an offset array and packed node and cost arrays, thus iterating the edges
+// of a node only touches contiguous memory. Compressed graphs (see compressed_arrays) use
+// less memory but have to decode the edges while iterating them.
+// Node is the unsigned type of the node indices and Cost the floating point type of the
+// edge costs, see SSSP_FOR_EACH_GRAPH_TYPE for the available instantiations.
+template <typename Node, typename Cost> class basic_graph_index;
+
+template <typename Node, typename Cost> class basic_graph {
+  public:
+    using node_type = Node;
+    using cost_type = Cost;
+    using edge_info = basic_edge_info<Node, Cost>;
+    using edge_range = basic_edge_range<Node, Cost>;
+
     // Empty graph.
-    graph();
+    basic_graph();
 
-    // Add a new node without edges.
-    size_t add_node();
-    // Add an edge between two nodes.
-    void add_edge(size_t source, size_t destination, double cost);
+    // The raw CSR arrays of a graph, see the members of basic_graph. The offsets have node_count + 1
+    // entries, all other arrays edge_count entries.
+    struct arrays {
+        size_t node_count;
+        size_t edge_count;
+        const size_t* outgoing_offsets;
+        const Node* outgoing_destinations;
+        const Cost* outgoing_costs;
+        const size_t* incoming_offsets;
+        const Node* incoming_sources;
+        const Cost* incoming_costs;
+        const size_t* incoming_edge_indices;
+    };
+
+    // The arrays of a compressed graph, which replace all arrays but the offsets. The edges of a node
+    // are stored as sorted list of the other nodes, encoded as gaps with read_varint, see
+    // basic_edge_iterator::decode. The byte offsets have node_count + 1 entries and point to the
+    // first byte of each node. The costs are stored once by edge index.
+    struct compressed_arrays {
+        const size_t* outgoing_byte_offsets;
+        const uint8_t* outgoing_bytes;
+        const size_t* incoming_byte_offsets;
+        const uint8_t* incoming_bytes;
+        const Cost* costs;
+    };
+
+    // Creates a graph using external arrays without copying them, e.g. from a memory mapped file.
+    // The arrays have to stay valid as long as keep_alive is referenced.
+    basic_graph(const arrays& arrays, std::shared_ptr<const void> keep_alive);
+    // Creates a compressed graph, only the counts and the offsets of arrays are used.
+    basic_graph(const arrays& arrays, const compressed_arrays& compressed, std::shared_ptr<const void> keep_alive);
+
+    // Returns the raw arrays, valid as long as the graph or a copy of it exists. Only the counts and
+    // the offsets are set for compressed graphs.
+    const arrays& raw_arrays() const { return m_arrays; }
+
+    // Returns true if the graph is compressed.
+    bool is_compressed() const { return m_compressed; }
+    // Returns the number of bytes used by the arrays of the graph.
+    size_t storage_size() const;
 
     // Returns the number of nodes.
     size_t node_count() const;
+    // Returns the number of edges.
+    size_t edge_count() const;
 
     // Returns all outgoing edges of a node.
-    const std::vector<edge_info>& outgoing_edges(size_t source) const;
+    edge_range outgoing_edges(Node source) const;
     // Returns all incoming edges of a node.
-    const std::vector<edge_info>& incoming_edges(size_t destination) const;
+    edge_range incoming_edges(Node destination) const;
+
+    // Returns the sorted edges and minimal costs of the graph, see basic_graph_index. The index is
+    // built by the first call and shared by all copies of the graph.
+    const basic_graph_index<Node, Cost>& index() const;
+    // Returns the shortest distances from the start node, see shortest_distances(). They are
+    // computed by the first call for each start node and shared by all copies of the graph.
+    const node_map<Cost>& reference_distances(size_t start_node) const;
+
+    // Returns the index of the position-th outgoing edge of source.
+    size_t edge_index(Node source, size_t position) const { return m_arrays.outgoing_offsets[source] + position; }
 
     // Creates a pre-filled node map by calling the callback.
     template <typename Fun> auto make_node_map(const Fun&& fn) const -> node_map<decltype(fn(0))> {
         node_map<decltype(fn(0))> result;
-        result.reserve(m_nodes.size());
-        for (size_t i = 0; i < m_nodes.size(); ++i) {
+        result.reserve(node_count());
+        for (size_t i = 0; i < node_count(); ++i) {
             result.emplace_back(fn(i));
         }
         return result;
     }
 
-    // Creates a pre-filled edge map by calling the callback.
-    template <typename Fun> auto make_edge_map(const Fun&& fn) const -> edge_map<decltype(fn(0, 0))> {
-        edge_map<decltype(fn(0, 0))> result;
-        result.reserve(m_edge_count);
-        for (size_t source = 0; source < m_nodes.size(); ++source) {
-            for (const edge_info& edge : m_nodes[source].outgoing) {
-                result[{source, edge.destination}] = fn(source, edge.destination);
+    // Creates a pre-filled edge map by calling the callback with each edge_info.
+    template <typename Fun> auto make_edge_map(const Fun&& fn) const -> edge_map<decltype(fn(edge_info(0, 0, 0)))> {
+        edge_map<decltype(fn(edge_info(0, 0, 0)))> result;
+        result.reserve(edge_count());
+        for (size_t source = 0; source < node_count(); ++source) {
+            for (const edge_info& edge : outgoing_edges(source)) {
+                result.emplace_back(fn(edge));
             }
         }
         return result;
     }
 
   private:
-    struct node {
-        std::vector<edge_info> incoming;
-        std::vector<edge_info> outgoing;
-    };
+    // m_arrays.*_offsets[n] to m_arrays.*_offsets[n + 1] is the range of node n in the other arrays.
+    // The arrays are owned by m_keep_alive, which is shared between copies of the graph. Either
+    // the storage of the builder or a memory mapped file.
+    arrays m_arrays;
+    bool m_compressed;
+    compressed_arrays m_compressed_arrays;
+    std::shared_ptr<const void> m_keep_alive;
 
-    std::vector<node> m_nodes;
-    size_t m_edge_count = 0;
+    struct shared_cache {
+        std::mutex mutex;
+        std::shared_ptr<const basic_graph_index<Node, Cost>> index;
+        std::map<size_t, std::shared_ptr<const node_map<Cost>>> distances;
+    };
+    // Shared between copies of the graph, filled by index() and reference_distances().
+    std::shared_ptr<shared_cache> m_cache;
 };
 
-} // namespace sssp
+// Collects nodes and edges to build a graph. Adding edges only appends them to an edge list,
+// all the work is done at once by build().
+template <typename Node, typename Cost> class basic_graph_builder {
+  public:
+    using edge_info = basic_edge_info<Node, Cost>;
 
-namespace std {
+    // Empty builder.
+    basic_graph_builder();
 
-template <> struct hash<sssp::edge_id> {
-    size_t operator()(const sssp::edge_id value) const {
-        size_t hash = 0;
-        boost::hash_combine(hash, value.source);
-        boost::hash_combine(hash, value.destination);
-        return hash;
-    }
+    // Add a new node without edges.
+    Node add_node();
+    // Add count new nodes without edges, returns the index of the first one.
+    Node add_nodes(size_t count);
+    // Add an edge between two nodes.
+    void add_edge(Node source, Node destination, Cost cost);
+    // Add a whole list of edges.
+    void add_edges(const std::vector<edge_info>& edges);
+    // Reserve memory for the given number of edges.
+    void reserve_edges(size_t edge_count);
+
+    // Returns the number of nodes added so far.
+    size_t node_count() const;
+
+    // Returns true if a graph with the given number of nodes can be indexed by Node.
+    static bool can_index(size_t node_count);
+
+    // Builds the graph. The edges are sorted and deduplicated in parallel: Self loops are removed
+    // and of parallel edges only the cheapest one is kept. Outgoing edges of a node are sorted by
+    // destination and incoming edges by source.
+    basic_graph<Node, Cost> build();
+    // Like build() but creates a compressed graph without creating the uncompressed arrays first.
+    // The edge costs are kept exactly, they are stored once instead of twice.
+    basic_graph<Node, Cost> build_compressed();
+
+  private:
+    // Sorts and deduplicates the edges, see build().
+    void sort_edges();
+
+    size_t m_node_count = 0;
+    std::vector<edge_info> m_edges;
 };
 
-} // namespace std
+// Returns a compressed copy of the graph.
+template <typename Node, typename Cost> basic_graph<Node, Cost> compress_graph(const basic_graph<Node, Cost>& graph);
+
+using edge_info = basic_edge_info<size_t, double>;
+using edge_range = basic_edge_range<size_t, double>;
+using graph = basic_graph<size_t, double>;
+using graph_builder = basic_graph_builder<size_t, double>;
+
+} // namespace sssp
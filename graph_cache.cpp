@@ -0,0 +1,171 @@
+#include "graph_cache.hpp"
+#include "graph_file.hpp"
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// 64 bit FNV-1a, which is stable across platforms and standard library implementations unlike
+// std::hash.
+static uint64_t fnv1a_hash(const std::string& text) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+// Maps the file and computes a checksum of its contents. If the file ends with a stored checksum,
+// the checksum is left out and returned in stored. Returns false if the file cannot be mapped.
+static bool checksum_file(const std::string& path, uint64_t& checksum, uint64_t* stored) {
+    namespace bi = boost::interprocess;
+    boost::system::error_code error;
+    boost::uintmax_t size = boost::filesystem::file_size(path, error);
+    if (error || size < sizeof(uint64_t)) {
+        return false;
+    }
+    bi::mapped_region region;
+    try {
+        region = bi::mapped_region(bi::file_mapping(path.c_str(), bi::read_only), bi::read_only);
+    } catch (const bi::interprocess_exception&) {
+        return false;
+    }
+    const char* data = static_cast<const char*>(region.get_address());
+    if (stored) {
+        size -= sizeof(uint64_t);
+        std::memcpy(stored, data + size, sizeof(uint64_t));
+    }
+
+    // FNV-1a over whole words, which is fast enough to check every read. The checksum only detects
+    // damaged files.
+    checksum = UINT64_C(14695981039346656037);
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, std::min<size_t>(sizeof(uint64_t), size - i));
+        checksum ^= word;
+        checksum *= UINT64_C(1099511628211);
+    }
+    return true;
+}
+
+std::string sssp::graph_cache_key(const arguments& args) {
+    std::ostringstream key;
+    key << std::setprecision(17);
+    key << "node_type=" << args.types.node << ";cost_type=" << args.types.cost << ";";
+    if (args.edge_gen.algorithm != edge_algorithm::kronecker) {
+        key << "position_gen=" << args.position_gen.algorithm << ";";
+        switch (args.position_gen.algorithm) {
+            case position_algorithm::poisson:
+                key << "min_distance=" << args.position_gen.poisson.min_distance
+                    << ";max_reject=" << args.position_gen.poisson.max_reject << ";";
+                break;
+            case position_algorithm::uniform:
+                key << "count=" << args.position_gen.uniform.count << ";";
+                break;
+        }
+    }
+    key << "edge_gen=" << args.edge_gen.algorithm << ";";
+    switch (args.edge_gen.algorithm) {
+        case edge_algorithm::planar:
+            key << "probability=" << args.edge_gen.planar.probability << ";";
+            break;
+        case edge_algorithm::uniform:
+            key << "probability=" << args.edge_gen.uniform.probability << ";";
+            break;
+        case edge_algorithm::layered:
+            key << "probability=" << args.edge_gen.layered.probability << ";count=" << args.edge_gen.layered.count
+                << ";";
+            break;
+        case edge_algorithm::kronecker:
+            key << "initiator=" << args.edge_gen.kronecker.initiator << ";k=" << args.edge_gen.kronecker.k << ";";
+            break;
+    }
+    key << "cost_gen=" << args.cost_gen.algorithm << ";seed=" << args.seed;
+    return key.str();
+}
+
+std::string sssp::graph_cache_path(const arguments& args) {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << fnv1a_hash(graph_cache_key(args)) << ".bin";
+    return (boost::filesystem::path(args.graph_cache) / name.str()).string();
+}
+
+template <typename Node, typename Cost>
+boost::optional<sssp::basic_graph<Node, Cost>> sssp::read_cached_graph(const arguments& args,
+                                                                      node_map<vec2>* positions) {
+    std::string path = graph_cache_path(args);
+    boost::system::error_code error;
+    if (!boost::filesystem::exists(path, error)) {
+        return {};
+    }
+    // Damaged or outdated cache files are silently replaced. The checksum behind the binary graph
+    // also covers damaged costs and positions that are still valid values.
+    uint64_t checksum;
+    uint64_t stored;
+    if (!checksum_file(path, checksum, &stored) || checksum != stored) {
+        return {};
+    }
+    return read_binary_graph<Node, Cost>(path, positions, nullptr);
+}
+
+template <typename Node, typename Cost>
+bool sssp::write_cached_graph(const arguments& args,
+                              const basic_graph<Node, Cost>& graph,
+                              const node_map<vec2>& positions,
+                              std::ostream* err) {
+    namespace fs = boost::filesystem;
+    boost::system::error_code error;
+    fs::create_directories(args.graph_cache, error);
+    if (error) {
+        if (err) {
+            (*err) << "Cannot create the graph cache directory " << args.graph_cache << ": " << error.message() << "\n";
+        }
+        return false;
+    }
+
+    fs::path path = graph_cache_path(args);
+    fs::path temporary = path;
+    temporary += fs::unique_path(".%%%%-%%%%-%%%%-%%%%.tmp");
+    if (!write_binary_graph(temporary.string(), graph, &positions, err)) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    uint64_t checksum;
+    bool written = checksum_file(temporary.string(), checksum, nullptr);
+    if (written) {
+        std::ofstream out(temporary.string(), std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        written = static_cast<bool>(out.flush());
+    }
+    if (!written) {
+        if (err) {
+            (*err) << "Cannot write the graph cache file " << temporary.string() << "\n";
+        }
+        fs::remove(temporary, error);
+        return false;
+    }
+    // Renaming is atomic, a concurrent run either sees the complete file or none. If several runs
+    // generate the same graph, the last one replaces the identical files of the others.
+    fs::rename(temporary, path, error);
+    if (error) {
+        if (err) {
+            (*err) << "Cannot write the graph cache file " << path.string() << ": " << error.message() << "\n";
+        }
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template boost::optional<sssp::basic_graph<NODE, COST>> sssp::read_cached_graph<NODE, COST>(const arguments&,      \
+                                                                                                node_map<vec2>*);      \
+    template bool sssp::write_cached_graph(                                                                            \
+        const arguments&, const basic_graph<NODE, COST>&, const node_map<vec2>&, std::ostream*);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -0,0 +1,37 @@
+#pragma once
+#include "arguments.hpp"
+#include "graph.hpp"
+#include "math.hpp"
+#include <boost/optional.hpp>
+#include <iostream>
+#include <string>
+
+namespace sssp {
+
+// Generated graphs can be stored in a cache directory (see --graph-cache) as binary graph files, so
+// that runs with the same generation arguments skip the generation. The file name is a 64 bit hash
+// of all arguments that influence the generated graph, including the node and cost types. A checksum
+// of the binary graph file is appended to it, so that damaged files are noticed.
+
+// Returns the arguments the generated graph depends on as a string. Arguments of algorithms that
+// are not used are left out.
+std::string graph_cache_key(const arguments& args);
+
+// Returns the path of the cache file for the arguments in args.graph_cache.
+std::string graph_cache_path(const arguments& args);
+
+// Loads the cached graph and its positions. Returns none if the graph is not cached or the cache
+// file cannot be read or its checksum does not match, in which case the graph has to be generated
+// again.
+template <typename Node, typename Cost>
+boost::optional<basic_graph<Node, Cost>> read_cached_graph(const arguments& args, node_map<vec2>* positions);
+
+// Stores the graph and its positions in the cache. The file is written under a temporary name and
+// then renamed, so concurrent runs never see partially written files. Returns false on errors.
+template <typename Node, typename Cost>
+bool write_cached_graph(const arguments& args,
+                        const basic_graph<Node, Cost>& graph,
+                        const node_map<vec2>& positions,
+                        std::ostream* err);
+
+} // namespace sssp
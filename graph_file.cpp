@@ -0,0 +1,765 @@
+#include "graph_file.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <boost/container_hash/hash.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/utility/string_view.hpp>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+namespace bi = boost::interprocess;
+
+// The offsets are stored as 64 bit integers and used directly as size_t.
+static_assert(sizeof(size_t) == sizeof(uint64_t), "binary graph files need a 64 bit size_t");
+
+static const char binary_magic[8] = {'S', 'S', 'S', 'P', 'G', 'R', 'P', 'H'};
+
+namespace {
+
+// Byte offsets of the arrays in a binary graph file.
+struct binary_layout {
+    size_t outgoing_offsets;
+    size_t outgoing_destinations;
+    size_t outgoing_costs;
+    size_t incoming_offsets;
+    size_t incoming_sources;
+    size_t incoming_costs;
+    size_t incoming_edge_indices;
+    size_t positions;
+    size_t end;
+};
+
+binary_layout make_binary_layout(const sssp::binary_graph_header& header) {
+    static constexpr size_t alignment = 64;
+    size_t at = 0;
+    auto next = [&](size_t bytes) {
+        size_t offset = (at + alignment - 1) / alignment * alignment;
+        at = offset + bytes;
+        return offset;
+    };
+
+    size_t nodes = header.node_count;
+    size_t edges = header.edge_count;
+    binary_layout layout;
+    next(sizeof(sssp::binary_graph_header));
+    layout.outgoing_offsets = next((nodes + 1) * sizeof(uint64_t));
+    layout.outgoing_destinations = next(edges * header.node_size);
+    layout.outgoing_costs = next(edges * header.cost_size);
+    layout.incoming_offsets = next((nodes + 1) * sizeof(uint64_t));
+    layout.incoming_sources = next(edges * header.node_size);
+    layout.incoming_costs = next(edges * header.cost_size);
+    layout.incoming_edge_indices = next(edges * sizeof(uint64_t));
+    layout.positions = next((header.flags & header.has_positions) ? nodes * 2 * sizeof(double) : 0);
+    layout.end = at;
+    return layout;
+}
+
+// Returns true if the offsets of a binary graph file start at 0, never decrease and end at the edge count.
+bool valid_offsets(const size_t* offsets, size_t node_count, size_t edge_count) {
+    if (offsets[0] != 0 || offsets[node_count] != edge_count) {
+        return false;
+    }
+    for (size_t node = 0; node < node_count; ++node) {
+        if (offsets[node] > offsets[node + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if all count values are below the bound.
+template <typename T> bool valid_indices(const T* values, size_t count, size_t bound) {
+    return std::all_of(values, values + count, [bound](T value) { return size_t(value) < bound; });
+}
+
+// Returns true if all count costs are non-negative. NaN costs are rejected as well.
+template <typename Cost> bool valid_costs(const Cost* costs, size_t count) {
+    return std::all_of(costs, costs + count, [](Cost cost) { return cost >= Cost(0); });
+}
+
+} // namespace
+
+namespace {
+
+// A word in a text file, pointing into the memory mapped file.
+using token = boost::string_view;
+
+// A text file mapped into memory. Empty files are not mapped, because mapping them fails.
+class text_file {
+  public:
+    bool open(const std::string& path, std::ostream* err) {
+        boost::system::error_code ec;
+        boost::uintmax_t size = boost::filesystem::file_size(path, ec);
+        try {
+            if (!ec && size > 0) {
+                m_region = bi::mapped_region(bi::file_mapping(path.c_str(), bi::read_only), bi::read_only);
+            }
+        } catch (const bi::interprocess_exception&) {
+            ec = boost::system::errc::make_error_code(boost::system::errc::io_error);
+        }
+        if (ec) {
+            if (err) {
+                (*err) << "Read error: " << path << "\n";
+            }
+            return false;
+        }
+        return true;
+    }
+
+    const char* begin() const { return static_cast<const char*>(m_region.get_address()); }
+    const char* end() const { return begin() + m_region.get_size(); }
+
+  private:
+    bi::mapped_region m_region;
+};
+
+bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// Returns the next whitespace separated word of the line and advances begin behind it.
+// The result is empty at the end of the line.
+token next_token(const char*& begin, const char* end) {
+    while (begin != end && is_space(*begin)) {
+        ++begin;
+    }
+    const char* token_begin = begin;
+    while (begin != end && !is_space(*begin)) {
+        ++begin;
+    }
+    return token(token_begin, begin - token_begin);
+}
+
+// Parses a non-negative decimal integer without sign. Returns false if the token is not one.
+bool parse_uint(token t, uint64_t& value) {
+    if (t.empty() || t.size() > 19) {
+        return false;
+    }
+    value = 0;
+    for (char c : t) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+// Whether the node name is an integer written without leading zeros. Only these names can be
+// compared as integers, "01" and "1" are different nodes.
+bool parse_integer_name(token t, uint64_t& value) {
+    return parse_uint(t, value) && (t.size() == 1 || t[0] != '0');
+}
+
+// Parses a floating point number. The whole token has to be a number.
+bool parse_double(token t, double& value) {
+    // strtod needs a null terminated string, the mapped file is not.
+    char buffer[64];
+    if (t.empty() || t.size() >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, t.data(), t.size());
+    buffer[t.size()] = '\0';
+    char* parsed_end = nullptr;
+    value = std::strtod(buffer, &parsed_end);
+    return parsed_end == buffer + t.size();
+}
+
+// Splits the text into one block of whole lines per thread and calls fn(block, begin, end)
+// for each block in parallel.
+template <typename Fun> void parallel_line_blocks(const char* begin, const char* end, size_t threads, const Fun& fn) {
+    // Small files are not worth the threads.
+    static constexpr size_t min_block_size = 1 << 20;
+    threads = std::max<size_t>(1, std::min<size_t>(threads, (end - begin) / min_block_size));
+
+    std::vector<const char*> bounds(threads + 1, end);
+    bounds[0] = begin;
+    for (size_t t = 1; t < threads; ++t) {
+        const char* at = std::max(bounds[t - 1], begin + (end - begin) * t / threads);
+        // Move the bound behind the next line break, unless it is at the start of a line already.
+        if (at != begin && at[-1] != '\n') {
+            at = std::find(at, end, '\n');
+            at = at == end ? end : at + 1;
+        }
+        bounds[t] = at;
+    }
+    sssp::parallel_for(threads, threads, [&](size_t t) { fn(t, bounds[t], bounds[t + 1]); });
+}
+
+// Calls fn(begin, end) for each line, the line break is excluded.
+template <typename Fun> void for_each_line(const char* begin, const char* end, const Fun& fn) {
+    while (begin != end) {
+        const char* line_end = std::find(begin, end, '\n');
+        fn(begin, line_end);
+        begin = line_end == end ? end : line_end + 1;
+    }
+}
+
+// Result of parsing one block of a file.
+struct parsed_block {
+    // Per edge the names of the source and destination node.
+    std::vector<token> names;
+    std::vector<double> costs;
+    // True if all node names are integers without leading zeros.
+    bool integer_names = true;
+    bool error = false;
+};
+
+// Numbers the names in the order of their first appearance with an array indexed by the names,
+// which have to be small integers. Returns the number of distinct names.
+size_t number_dense_names(const std::vector<uint64_t>& names, uint64_t max_name, std::vector<size_t>& nodes) {
+    std::vector<size_t> node_of(max_name + 1, size_t(-1));
+    size_t node_count = 0;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (node_of[names[i]] == size_t(-1)) {
+            node_of[names[i]] = node_count++;
+        }
+        nodes[i] = node_of[names[i]];
+    }
+    return node_count;
+}
+
+// Numbers the names in the order of their first appearance by sorting them, which is faster than
+// a hash map for many distinct names and runs in parallel. Returns the number of distinct names.
+template <typename Key>
+size_t number_sorted_names(const std::vector<Key>& names, std::vector<size_t>& nodes, size_t threads) {
+    // Sorting by name and appearance makes the first entry of each name its first appearance.
+    std::vector<std::pair<Key, size_t>> sorted(names.size());
+    sssp::parallel_for(names.size(), threads, [&](size_t i) { sorted[i] = std::make_pair(names[i], i); });
+    sssp::parallel_sort(sorted.begin(), sorted.end(), std::less<std::pair<Key, size_t>>(), threads);
+
+    // The groups of equal names as first appearance and range in sorted.
+    std::vector<std::tuple<size_t, size_t, size_t>> groups;
+    for (size_t begin = 0; begin < sorted.size();) {
+        size_t end = begin + 1;
+        while (end < sorted.size() && sorted[end].first == sorted[begin].first) {
+            ++end;
+        }
+        groups.emplace_back(sorted[begin].second, begin, end);
+        begin = end;
+    }
+    sssp::parallel_sort(groups.begin(), groups.end(), std::less<std::tuple<size_t, size_t, size_t>>(), threads);
+
+    sssp::parallel_for(groups.size(), threads, [&](size_t node) {
+        for (size_t i = std::get<1>(groups[node]); i < std::get<2>(groups[node]); ++i) {
+            nodes[sorted[i].second] = node;
+        }
+    });
+    return groups.size();
+}
+
+} // namespace
+
+template <typename Node, typename Cost>
+bool sssp::read_edge_list(const std::string& path,
+                          basic_graph_builder<Node, Cost>& builder,
+                          std::ostream* err,
+                          size_t threads) {
+    text_file file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+
+    std::vector<parsed_block> blocks(threads);
+    parallel_line_blocks(file.begin(), file.end(), threads, [&](size_t b, const char* begin, const char* end) {
+        parsed_block& block = blocks[b];
+        for_each_line(begin, end, [&](const char* line, const char* line_end) {
+            if (block.error) {
+                return;
+            }
+            token source = next_token(line, line_end);
+            if (source.empty() || source.starts_with("#") || source.starts_with("//") || source.starts_with("--")) {
+                return;
+            }
+            token destination = next_token(line, line_end);
+            token cost_token = next_token(line, line_end);
+            double cost = 1.0;
+            if (destination.empty() || (!cost_token.empty() && !parse_double(cost_token, cost))) {
+                block.error = true;
+                return;
+            }
+            uint64_t unused;
+            block.integer_names =
+                block.integer_names && parse_integer_name(source, unused) && parse_integer_name(destination, unused);
+            block.names.push_back(source);
+            block.names.push_back(destination);
+            block.costs.push_back(cost);
+        });
+    });
+
+    bool integer_names = true;
+    std::vector<token> names;
+    std::vector<double> costs;
+    for (const parsed_block& block : blocks) {
+        if (block.error) {
+            if (err) {
+                (*err) << "Parse error in " << path << "!\n";
+            }
+            return false;
+        }
+        integer_names = integer_names && block.integer_names;
+        names.insert(names.end(), block.names.begin(), block.names.end());
+        costs.insert(costs.end(), block.costs.begin(), block.costs.end());
+    }
+
+    // The nodes are numbered in the order of their first appearance, names[2 * e] and
+    // names[2 * e + 1] are the source and destination of edge e.
+    std::vector<size_t> nodes(names.size());
+    size_t node_count = 0;
+    if (integer_names) {
+        // Fast path: integer names are compared as integers and dense ones looked up in an array.
+        std::vector<uint64_t> keys(names.size());
+        parallel_for(names.size(), threads, [&](size_t i) { parse_uint(names[i], keys[i]); });
+        uint64_t max_key = keys.empty() ? 0 : *std::max_element(keys.begin(), keys.end());
+        if (max_key < 4 * keys.size()) {
+            node_count = number_dense_names(keys, max_key, nodes);
+        } else {
+            node_count = number_sorted_names(keys, nodes, threads);
+        }
+    } else {
+        // Comparing the hashes first avoids most string comparisons.
+        std::vector<std::pair<size_t, token>> keys(names.size());
+        parallel_for(
+            names.size(), threads, [&](size_t i) { keys[i] = std::make_pair(boost::hash_value(names[i]), names[i]); });
+        node_count = number_sorted_names(keys, nodes, threads);
+    }
+
+    if (!builder.can_index(builder.node_count() + node_count)) {
+        if (err) {
+            (*err) << "Too many nodes in " << path << " for the node index type!\n";
+        }
+        return false;
+    }
+    Node first = builder.add_nodes(node_count);
+    std::vector<typename basic_graph_builder<Node, Cost>::edge_info> edges(
+        costs.size(), typename basic_graph_builder<Node, Cost>::edge_info(0, 0, 0));
+    parallel_for(costs.size(), threads, [&](size_t e) {
+        edges[e] = typename basic_graph_builder<Node, Cost>::edge_info(static_cast<Node>(first + nodes[2 * e]),
+                                                                       static_cast<Node>(first + nodes[2 * e + 1]),
+                                                                       static_cast<Cost>(costs[e]));
+    });
+    builder.add_edges(edges);
+    return true;
+}
+
+template <typename Node, typename Cost>
+bool sssp::read_dimacs(const std::string& path,
+                       basic_graph_builder<Node, Cost>& builder,
+                       std::ostream* err,
+                       size_t threads) {
+    text_file file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+
+    // Each block finds the problem line itself, the node count is checked after parsing.
+    struct dimacs_block {
+        std::vector<std::tuple<uint64_t, uint64_t, double>> arcs;
+        uint64_t node_count = 0;
+        bool error = false;
+    };
+    std::vector<dimacs_block> blocks(threads);
+    parallel_line_blocks(file.begin(), file.end(), threads, [&](size_t b, const char* begin, const char* end) {
+        dimacs_block& block = blocks[b];
+        for_each_line(begin, end, [&](const char* line, const char* line_end) {
+            token type = next_token(line, line_end);
+            if (block.error || type.empty() || type == "c") {
+                return;
+            }
+            if (type == "p") {
+                token problem = next_token(line, line_end);
+                block.error = problem != "sp" || !parse_uint(next_token(line, line_end), block.node_count);
+            } else if (type == "a") {
+                uint64_t source = 0;
+                uint64_t destination = 0;
+                double cost = 0.0;
+                block.error = !parse_uint(next_token(line, line_end), source) ||
+                              !parse_uint(next_token(line, line_end), destination) ||
+                              !parse_double(next_token(line, line_end), cost);
+                block.arcs.emplace_back(source, destination, cost);
+            } else {
+                block.error = true;
+            }
+        });
+    });
+
+    uint64_t node_count = 0;
+    for (const dimacs_block& block : blocks) {
+        node_count = std::max(node_count, block.node_count);
+        if (block.error) {
+            if (err) {
+                (*err) << "Parse error in " << path << "!\n";
+            }
+            return false;
+        }
+    }
+    if (!builder.can_index(builder.node_count() + node_count)) {
+        if (err) {
+            (*err) << "Too many nodes in " << path << " for the node index type!\n";
+        }
+        return false;
+    }
+
+    Node first = builder.add_nodes(node_count);
+    for (const dimacs_block& block : blocks) {
+        std::vector<typename basic_graph_builder<Node, Cost>::edge_info> edges;
+        edges.reserve(block.arcs.size());
+        for (const auto& arc : block.arcs) {
+            // The nodes are numbered from 1 to node_count.
+            if (std::get<0>(arc) < 1 || std::get<0>(arc) > node_count || std::get<1>(arc) < 1 ||
+                std::get<1>(arc) > node_count) {
+                if (err) {
+                    (*err) << "Invalid node in " << path << "!\n";
+                }
+                return false;
+            }
+            edges.emplace_back(static_cast<Node>(first + std::get<0>(arc) - 1),
+                               static_cast<Node>(first + std::get<1>(arc) - 1),
+                               static_cast<Cost>(std::get<2>(arc)));
+        }
+        builder.add_edges(edges);
+    }
+    return true;
+}
+
+template <typename Node, typename Cost>
+bool sssp::read_metis(const std::string& path,
+                      basic_graph_builder<Node, Cost>& builder,
+                      std::ostream* err,
+                      size_t threads) {
+    text_file file;
+    if (!file.open(path, err)) {
+        return false;
+    }
+    auto parse_error = [&] {
+        if (err) {
+            (*err) << "Parse error in " << path << "!\n";
+        }
+        return false;
+    };
+    auto is_comment = [](const char* line, const char* line_end) { return line != line_end && *line == '%'; };
+
+    // The header is the first line that is not a comment.
+    const char* body = file.begin();
+    const char* header = body;
+    const char* header_end = body;
+    while (body != file.end()) {
+        header = body;
+        header_end = std::find(body, file.end(), '\n');
+        body = header_end == file.end() ? header_end : header_end + 1;
+        if (!is_comment(header, header_end)) {
+            break;
+        }
+    }
+    uint64_t node_count = 0;
+    uint64_t edge_count = 0;
+    uint64_t format = 0;
+    uint64_t constraints = 1;
+    if (!parse_uint(next_token(header, header_end), node_count) ||
+        !parse_uint(next_token(header, header_end), edge_count)) {
+        return parse_error();
+    }
+    token format_token = next_token(header, header_end);
+    token constraints_token = next_token(header, header_end);
+    if ((!format_token.empty() && !parse_uint(format_token, format)) ||
+        (!constraints_token.empty() && !parse_uint(constraints_token, constraints))) {
+        return parse_error();
+    }
+    // The digits of the format tell if there are vertex sizes, vertex weights and edge weights.
+    bool vertex_sizes = (format / 100) % 10 == 1;
+    size_t vertex_weights = (format / 10) % 10 == 1 ? constraints : 0;
+    bool edge_weights = format % 10 == 1;
+
+    // Every line is one node, so the blocks count their lines to number the nodes afterwards.
+    struct metis_block {
+        // Per line the end of its edges in the edge arrays.
+        std::vector<size_t> line_ends;
+        std::vector<uint64_t> neighbours;
+        std::vector<double> costs;
+        bool error = false;
+    };
+    std::vector<metis_block> blocks(threads);
+    parallel_line_blocks(body, file.end(), threads, [&](size_t b, const char* begin, const char* end) {
+        metis_block& block = blocks[b];
+        for_each_line(begin, end, [&](const char* line, const char* line_end) {
+            if (block.error || is_comment(line, line_end)) {
+                return;
+            }
+            uint64_t unused = 0;
+            for (size_t i = 0; i < vertex_weights + (vertex_sizes ? 1 : 0); ++i) {
+                block.error = block.error || !parse_uint(next_token(line, line_end), unused);
+            }
+            for (token t = next_token(line, line_end); !t.empty(); t = next_token(line, line_end)) {
+                uint64_t neighbour = 0;
+                double cost = 1.0;
+                block.error = block.error || !parse_uint(t, neighbour) ||
+                              (edge_weights && !parse_double(next_token(line, line_end), cost));
+                block.neighbours.push_back(neighbour);
+                block.costs.push_back(cost);
+            }
+            block.line_ends.push_back(block.neighbours.size());
+        });
+    });
+
+    size_t lines = 0;
+    for (const metis_block& block : blocks) {
+        if (block.error) {
+            return parse_error();
+        }
+        lines += block.line_ends.size();
+    }
+    if (lines < node_count) {
+        return parse_error();
+    }
+    if (!builder.can_index(builder.node_count() + node_count)) {
+        if (err) {
+            (*err) << "Too many nodes in " << path << " for the node index type!\n";
+        }
+        return false;
+    }
+
+    Node first = builder.add_nodes(node_count);
+    builder.reserve_edges(2 * edge_count);
+    size_t source = 0;
+    for (const metis_block& block : blocks) {
+        std::vector<typename basic_graph_builder<Node, Cost>::edge_info> edges;
+        edges.reserve(block.neighbours.size());
+        size_t line_begin = 0;
+        for (size_t line_end : block.line_ends) {
+            for (size_t e = line_begin; e < line_end; ++e) {
+                // The nodes are numbered from 1 to node_count, lines behind the last node must be empty.
+                if (block.neighbours[e] < 1 || block.neighbours[e] > node_count || source >= node_count) {
+                    if (err) {
+                        (*err) << "Invalid node in " << path << "!\n";
+                    }
+                    return false;
+                }
+                edges.emplace_back(static_cast<Node>(first + source),
+                                   static_cast<Node>(first + block.neighbours[e] - 1),
+                                   static_cast<Cost>(block.costs[e]));
+            }
+            line_begin = line_end;
+            source += 1;
+        }
+        builder.add_edges(edges);
+    }
+    return true;
+}
+
+sssp::graph_format sssp::guess_graph_format(const std::string& path) {
+    if (is_binary_graph_file(path)) {
+        return graph_format::binary;
+    }
+    std::string extension = boost::algorithm::to_lower_copy(boost::filesystem::path(path).extension().string());
+    if (extension == ".gr") {
+        return graph_format::dimacs;
+    } else if (extension == ".graph" || extension == ".metis") {
+        return graph_format::metis;
+    } else {
+        return graph_format::edge_list;
+    }
+}
+
+template <typename Node, typename Cost>
+bool sssp::read_text_graph(const std::string& path,
+                           graph_format format,
+                           basic_graph_builder<Node, Cost>& builder,
+                           std::ostream* err,
+                           size_t threads) {
+    if (format == graph_format::guess) {
+        format = guess_graph_format(path);
+    }
+    switch (format) {
+        case graph_format::edge_list:
+            return read_edge_list(path, builder, err, threads);
+        case graph_format::dimacs:
+            return read_dimacs(path, builder, err, threads);
+        case graph_format::metis:
+            return read_metis(path, builder, err, threads);
+        default:
+            if (err) {
+                (*err) << path << " is not a text graph file!\n";
+            }
+            return false;
+    }
+}
+
+bool sssp::is_binary_graph_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(binary_magic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, binary_magic, sizeof(magic)) == 0;
+}
+
+template <typename Node, typename Cost>
+bool sssp::write_binary_graph(const std::string& path,
+                              const basic_graph<Node, Cost>& graph,
+                              const node_map<vec2>* positions,
+                              std::ostream* err) {
+    if (graph.is_compressed()) {
+        if (err) {
+            (*err) << "Compressed graphs cannot be written to binary graph files.\n";
+        }
+        return false;
+    }
+
+    binary_graph_header header;
+    std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+    header.version = binary_graph_header::current_version;
+    header.node_size = sizeof(Node);
+    header.cost_size = sizeof(Cost);
+    header.flags = positions ? binary_graph_header::has_positions : 0;
+    header.node_count = graph.node_count();
+    header.edge_count = graph.edge_count();
+    binary_layout layout = make_binary_layout(header);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    auto write_at = [&](size_t offset, const void* data, size_t bytes) {
+        static const char zeros[64] = {};
+        size_t at = static_cast<size_t>(out.tellp());
+        out.write(zeros, offset - at);
+        out.write(static_cast<const char*>(data), bytes);
+    };
+
+    const auto& arrays = graph.raw_arrays();
+    size_t nodes = graph.node_count();
+    size_t edges = graph.edge_count();
+    write_at(0, &header, sizeof(header));
+    write_at(layout.outgoing_offsets, arrays.outgoing_offsets, (nodes + 1) * sizeof(size_t));
+    write_at(layout.outgoing_destinations, arrays.outgoing_destinations, edges * sizeof(Node));
+    write_at(layout.outgoing_costs, arrays.outgoing_costs, edges * sizeof(Cost));
+    write_at(layout.incoming_offsets, arrays.incoming_offsets, (nodes + 1) * sizeof(size_t));
+    write_at(layout.incoming_sources, arrays.incoming_sources, edges * sizeof(Node));
+    write_at(layout.incoming_costs, arrays.incoming_costs, edges * sizeof(Cost));
+    write_at(layout.incoming_edge_indices, arrays.incoming_edge_indices, edges * sizeof(size_t));
+    if (positions) {
+        std::vector<double> coordinates;
+        coordinates.reserve(2 * nodes);
+        for (const vec2& position : *positions) {
+            coordinates.push_back(position.x);
+            coordinates.push_back(position.y);
+        }
+        write_at(layout.positions, coordinates.data(), coordinates.size() * sizeof(double));
+    }
+    write_at(layout.end, nullptr, 0);
+
+    out.flush();
+    if (!out) {
+        if (err) {
+            (*err) << "Could not write " << path << "\n";
+        }
+        return false;
+    }
+    return true;
+}
+
+template <typename Node, typename Cost>
+boost::optional<sssp::basic_graph<Node, Cost>>
+sssp::read_binary_graph(const std::string& path, node_map<vec2>* positions, std::ostream* err) {
+    std::shared_ptr<bi::mapped_region> region;
+    try {
+        region = std::make_shared<bi::mapped_region>(bi::file_mapping(path.c_str(), bi::read_only), bi::read_only);
+    } catch (const bi::interprocess_exception& ex) {
+        if (err) {
+            (*err) << "Could not map " << path << ": " << ex.what() << "\n";
+        }
+        return {};
+    }
+    const char* data = static_cast<const char*>(region->get_address());
+
+    binary_graph_header header;
+    if (region->get_size() < sizeof(header) || std::memcmp(data, binary_magic, sizeof(binary_magic)) != 0) {
+        if (err) {
+            (*err) << path << " is not a binary graph file!\n";
+        }
+        return {};
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != binary_graph_header::current_version) {
+        if (err) {
+            (*err) << path << " has the unsupported version " << header.version << "!\n";
+        }
+        return {};
+    }
+    if (header.node_size != sizeof(Node) || header.cost_size != sizeof(Cost)) {
+        if (err) {
+            (*err) << path << " uses " << 8 * header.node_size << " bit node indices and " << 8 * header.cost_size
+                   << " bit costs, choose the matching `--node-type` and `--cost-type`!\n";
+        }
+        return {};
+    }
+
+    // Every node takes two offsets and every edge its endpoints, costs and an edge index. Counts
+    // that cannot fit into the file are rejected before the layout is computed, so it cannot overflow.
+    size_t payload = region->get_size() - sizeof(header);
+    size_t edge_bytes = 2 * header.node_size + 2 * header.cost_size + sizeof(uint64_t);
+    if (header.node_count > payload / (2 * sizeof(uint64_t)) || header.edge_count > payload / edge_bytes) {
+        if (err) {
+            (*err) << path << " is corrupt!\n";
+        }
+        return {};
+    }
+
+    binary_layout layout = make_binary_layout(header);
+    typename basic_graph<Node, Cost>::arrays arrays{
+        header.node_count,
+        header.edge_count,
+        reinterpret_cast<const size_t*>(data + layout.outgoing_offsets),
+        reinterpret_cast<const Node*>(data + layout.outgoing_destinations),
+        reinterpret_cast<const Cost*>(data + layout.outgoing_costs),
+        reinterpret_cast<const size_t*>(data + layout.incoming_offsets),
+        reinterpret_cast<const Node*>(data + layout.incoming_sources),
+        reinterpret_cast<const Cost*>(data + layout.incoming_costs),
+        reinterpret_cast<const size_t*>(data + layout.incoming_edge_indices),
+    };
+    // The file is loaded without parsing, so every index is checked once. Otherwise a damaged file
+    // makes the algorithms read out of bounds as soon as they walk the edges.
+    size_t nodes = header.node_count;
+    size_t edges = header.edge_count;
+    if (region->get_size() < layout.end || !basic_graph_builder<Node, Cost>::can_index(nodes) ||
+        !valid_offsets(arrays.outgoing_offsets, nodes, edges) ||
+        !valid_offsets(arrays.incoming_offsets, nodes, edges) ||
+        !valid_indices(arrays.outgoing_destinations, edges, nodes) ||
+        !valid_indices(arrays.incoming_sources, edges, nodes) ||
+        !valid_indices(arrays.incoming_edge_indices, edges, edges) || !valid_costs(arrays.outgoing_costs, edges) ||
+        !valid_costs(arrays.incoming_costs, edges)) {
+        if (err) {
+            (*err) << path << " is corrupt!\n";
+        }
+        return {};
+    }
+
+    if (positions) {
+        positions->assign(header.node_count, vec2(0.0, 0.0));
+        if (header.flags & binary_graph_header::has_positions) {
+            const double* coordinates = reinterpret_cast<const double*>(data + layout.positions);
+            for (size_t node = 0; node < header.node_count; ++node) {
+                (*positions)[node] = vec2(coordinates[2 * node], coordinates[2 * node + 1]);
+            }
+        }
+    }
+
+    return basic_graph<Node, Cost>(arrays, std::move(region));
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template bool sssp::read_edge_list(                                                                                \
+        const std::string&, basic_graph_builder<NODE, COST>&, std::ostream*, size_t);                                  \
+    template bool sssp::read_dimacs(                                                                                   \
+        const std::string&, basic_graph_builder<NODE, COST>&, std::ostream*, size_t);                                  \
+    template bool sssp::read_metis(                                                                                    \
+        const std::string&, basic_graph_builder<NODE, COST>&, std::ostream*, size_t);                                  \
+    template bool sssp::read_text_graph(                                                                               \
+        const std::string&, graph_format, basic_graph_builder<NODE, COST>&, std::ostream*, size_t);                    \
+    template bool sssp::write_binary_graph(                                                                            \
+        const std::string&, const basic_graph<NODE, COST>&, const node_map<vec2>*, std::ostream*);                     \
+    template boost::optional<sssp::basic_graph<NODE, COST>> sssp::read_binary_graph<NODE, COST>(                       \
+        const std::string&, node_map<vec2>*, std::ostream*);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
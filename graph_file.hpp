@@ -0,0 +1,94 @@
+#pragma once
+#include "arguments.hpp"
+#include "graph.hpp"
+#include "math.hpp"
+#include "parallel.hpp"
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace sssp {
+
+// Reads a text file with the line-format `source destination cost`, with cost being optional and
+// 1.0 by default. Node names are arbitrary words and are numbered in the order of appearance.
+// Empty lines and lines starting with #, // or -- are ignored. The file is parsed by the given
+// number of threads, the result does not depend on their number. Returns false on errors.
+template <typename Node, typename Cost>
+bool read_edge_list(const std::string& path,
+                    basic_graph_builder<Node, Cost>& builder,
+                    std::ostream* err,
+                    size_t threads = default_thread_count());
+
+// Reads a graph in the shortest path format of the 9th DIMACS implementation challenge (.gr):
+// A problem line `p sp nodes arcs` and lines `a source destination cost` with nodes numbered from 1.
+// Lines starting with c are comments. The file is parsed by the given number of threads. Returns
+// false on errors.
+template <typename Node, typename Cost>
+bool read_dimacs(const std::string& path,
+                 basic_graph_builder<Node, Cost>& builder,
+                 std::ostream* err,
+                 size_t threads = default_thread_count());
+
+// Reads an undirected graph in the METIS format: A header `nodes edges [format [constraints]]`
+// followed by one line per node listing its neighbours numbered from 1, each followed by the
+// edge cost if the format ends with 1. Vertex sizes and weights are ignored. Each undirected edge
+// is listed by both of its nodes and becomes two directed edges. Lines starting with % are
+// comments. The file is parsed by the given number of threads. Returns false on errors.
+template <typename Node, typename Cost>
+bool read_metis(const std::string& path,
+                basic_graph_builder<Node, Cost>& builder,
+                std::ostream* err,
+                size_t threads = default_thread_count());
+
+// Guesses the format of a graph file: Binary graph files are recognized by their content,
+// .gr files are DIMACS, .graph and .metis files are METIS and all others edge lists.
+graph_format guess_graph_format(const std::string& path);
+
+// Reads a graph file in one of the text formats with the given number of threads, guessing the
+// format if requested. Returns false on errors.
+template <typename Node, typename Cost>
+bool read_text_graph(const std::string& path,
+                     graph_format format,
+                     basic_graph_builder<Node, Cost>& builder,
+                     std::ostream* err,
+                     size_t threads = default_thread_count());
+
+// Binary graph files store the CSR arrays of a graph (see basic_graph::arrays) so that they can be
+// memory mapped and used without parsing or copying. The file starts with this header, followed by
+// the arrays outgoing_offsets, outgoing_destinations, outgoing_costs, incoming_offsets,
+// incoming_sources, incoming_costs, incoming_edge_indices and optionally the positions as pairs
+// of doubles. Each array starts at a multiple of 64 bytes. All numbers use the native byte order.
+struct binary_graph_header {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t has_positions = 1;
+
+    char magic[8];
+    uint32_t version;
+    // Size of a node index and of an edge cost in bytes.
+    uint32_t node_size;
+    uint32_t cost_size;
+    uint32_t flags;
+    uint64_t node_count;
+    uint64_t edge_count;
+};
+
+// Returns true if the file starts with the magic bytes of a binary graph file.
+bool is_binary_graph_file(const std::string& path);
+
+// Writes the graph to a binary graph file. The positions are stored if they are given. The graph
+// must not be compressed. Returns false on errors.
+template <typename Node, typename Cost>
+bool write_binary_graph(const std::string& path,
+                        const basic_graph<Node, Cost>& graph,
+                        const node_map<vec2>* positions,
+                        std::ostream* err);
+
+// Memory maps a binary graph file. All offsets, node indices and costs are checked once, so damaged
+// files are rejected. The positions are copied if the file contains them, otherwise positions is
+// filled with zeros. The file has to use the same node index and cost types. Returns none on errors.
+template <typename Node, typename Cost>
+boost::optional<basic_graph<Node, Cost>>
+read_binary_graph(const std::string& path, node_map<vec2>* positions, std::ostream* err);
+
+} // namespace sssp
@@ -0,0 +1,48 @@
+#include "graph_index.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+
+template <typename Node, typename Cost>
+sssp::basic_graph_index<Node, Cost>::basic_graph_index(const basic_graph<Node, Cost>& graph)
+    : m_incoming_offsets(graph.raw_arrays().incoming_offsets),
+      m_outgoing_offsets(graph.raw_arrays().outgoing_offsets), m_incoming(graph.edge_count()),
+      m_outgoing(graph.edge_count()), m_two_hop(graph.edge_count()), m_min_incoming(graph.node_count()),
+      m_min_outgoing(graph.node_count()) {
+    const size_t threads = default_thread_count();
+    auto by_cost = [](const neighbour& a, const neighbour& b) { return a.cost < b.cost; };
+
+    parallel_for(graph.node_count(), threads, [&](size_t node) {
+        neighbour* incoming = m_incoming.data() + m_incoming_offsets[node];
+        for (const auto& edge : graph.incoming_edges(static_cast<Node>(node))) {
+            *incoming++ = neighbour{edge.source, edge.cost};
+        }
+        std::sort(m_incoming.data() + m_incoming_offsets[node], incoming, by_cost);
+        m_min_incoming[node] = m_incoming_offsets[node] == m_incoming_offsets[node + 1]
+                                   ? Cost(INFINITY)
+                                   : m_incoming[m_incoming_offsets[node]].cost;
+
+        neighbour* outgoing = m_outgoing.data() + m_outgoing_offsets[node];
+        for (const auto& edge : graph.outgoing_edges(static_cast<Node>(node))) {
+            *outgoing++ = neighbour{edge.destination, edge.cost};
+        }
+        std::sort(m_outgoing.data() + m_outgoing_offsets[node], outgoing, by_cost);
+        m_min_outgoing[node] = m_outgoing_offsets[node] == m_outgoing_offsets[node + 1]
+                                   ? Cost(INFINITY)
+                                   : m_outgoing[m_outgoing_offsets[node]].cost;
+    });
+
+    // Needs the minimal incoming costs of all predecessors.
+    parallel_for(graph.node_count(), threads, [&](size_t node) {
+        neighbour* begin = m_two_hop.data() + m_incoming_offsets[node];
+        neighbour* end = m_two_hop.data() + m_incoming_offsets[node + 1];
+        const neighbour* incoming = m_incoming.data() + m_incoming_offsets[node];
+        for (neighbour* two_hop = begin; two_hop != end; ++two_hop, ++incoming) {
+            *two_hop = neighbour{incoming->node, m_min_incoming[incoming->node] + incoming->cost};
+        }
+        std::sort(begin, end, by_cost);
+    });
+}
+
+#define SSSP_INSTANTIATE(NODE, COST) template class sssp::basic_graph_index<NODE, COST>;
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
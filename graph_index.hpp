@@ -0,0 +1,75 @@
+#pragma once
+#include "graph.hpp"
+#include <boost/assert.hpp>
+#include <vector>
+
+namespace sssp {
+
+// Precomputed views of the edges of a graph used by several criteria: the incoming and outgoing
+// edges of each node sorted by cost, the minimal incoming and outgoing cost of each node and the
+// minimal cost of two-hop paths into each node. Use basic_graph::index() to get the index of a
+// graph, which builds it once and shares it between all users of the graph.
+template <typename Node, typename Cost> class basic_graph_index {
+  public:
+    // An edge seen from one of its nodes: the node at the other end and the cost.
+    struct neighbour {
+        Node node;
+        Cost cost;
+    };
+
+    // A range of neighbours. Criteria keep copies of ranges and drop the neighbours at the front
+    // they are no longer interested in.
+    class neighbour_range {
+      public:
+        neighbour_range(const neighbour* begin, const neighbour* end) : m_begin(begin), m_end(end) {}
+
+        const neighbour* begin() const { return m_begin; }
+        const neighbour* end() const { return m_end; }
+        size_t size() const { return m_end - m_begin; }
+        bool empty() const { return m_begin == m_end; }
+        const neighbour& front() const {
+            BOOST_ASSERT(!empty());
+            return *m_begin;
+        }
+        void pop_front() {
+            BOOST_ASSERT(!empty());
+            ++m_begin;
+        }
+
+      private:
+        const neighbour* m_begin;
+        const neighbour* m_end;
+    };
+
+    // Builds the index with multiple threads. The offsets of the graph have to stay valid as long
+    // as the index exists.
+    explicit basic_graph_index(const basic_graph<Node, Cost>& graph);
+
+    // The sources and costs of the incoming edges of the node by ascending cost.
+    neighbour_range incoming(size_t node) const { return range(m_incoming, m_incoming_offsets, node); }
+    // The destinations and costs of the outgoing edges of the node by ascending cost.
+    neighbour_range outgoing(size_t node) const { return range(m_outgoing, m_outgoing_offsets, node); }
+    // Each predecessor p of the node with cost(p, node) + min_incoming_cost(p), by ascending cost.
+    neighbour_range two_hop_incoming(size_t node) const { return range(m_two_hop, m_incoming_offsets, node); }
+
+    // The minimal cost of the incoming or outgoing edges of the node, infinity without edges.
+    Cost min_incoming_cost(size_t node) const { return m_min_incoming[node]; }
+    Cost min_outgoing_cost(size_t node) const { return m_min_outgoing[node]; }
+
+  private:
+    static neighbour_range range(const std::vector<neighbour>& neighbours, const size_t* offsets, size_t node) {
+        return neighbour_range(neighbours.data() + offsets[node], neighbours.data() + offsets[node + 1]);
+    }
+
+    const size_t* m_incoming_offsets;
+    const size_t* m_outgoing_offsets;
+    std::vector<neighbour> m_incoming;
+    std::vector<neighbour> m_outgoing;
+    std::vector<neighbour> m_two_hop;
+    node_map<Cost> m_min_incoming;
+    node_map<Cost> m_min_outgoing;
+};
+
+using graph_index = basic_graph_index<size_t, double>;
+
+} // namespace sssp
@@ -0,0 +1,31 @@
+#pragma once
+#include "dijkstra.hpp"
+#include "graph.hpp"
+#include <vector>
+
+namespace sssp {
+
+// The statistics of a phase of a label correcting algorithm, which may relax a node in more than
+// one phase.
+struct label_correcting_phase {
+    // The nodes whose edges were relaxed, including the re-relaxed nodes.
+    size_t relaxed = 0;
+    // The nodes whose edges had already been relaxed in an earlier phase.
+    size_t rerelaxed = 0;
+    // The nodes waiting to be relaxed at the start of the phase.
+    size_t fringe_size = 0;
+};
+
+template <typename Node, typename Cost> struct basic_label_correcting_result {
+    // The distances and predecessors. relaxation_phase and fringe_size are those of the last phase
+    // relaxing the node, after which its distance did not change anymore.
+    node_map<basic_dijkstra_result<Node, Cost>> nodes;
+    std::vector<label_correcting_phase> phases;
+    // The bucket width delta_stepping() used, which may be wider than requested. 0 for the other
+    // algorithms.
+    Cost delta = 0;
+};
+
+using label_correcting_result = basic_label_correcting_result<size_t, double>;
+
+} // namespace sssp
@@ -0,0 +1,144 @@
+#include "crit_dijkstra.hpp"
+#include "dijkstra.hpp"
+#include "generate_edges.hpp"
+#include "generate_positions.hpp"
+#include <boost/heap/pairing_heap.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+
+namespace {
+
+// Dijkstra's algorithm on the pairing heap that smallest_tentative_distance used before the radix heap.
+sssp::node_map<double> pairing_heap_distances(const sssp::graph& graph, size_t start_node) {
+    using entry = std::tuple<double, size_t>;
+    using queue = boost::heap::pairing_heap<entry, boost::heap::compare<std::greater<entry>>>;
+    sssp::node_map<double> distances(graph.node_count(), INFINITY);
+    sssp::node_map<queue::handle_type> handles(graph.node_count());
+    std::vector<bool> settled(graph.node_count(), false);
+    queue q;
+    distances[start_node] = 0;
+    handles[start_node] = q.push(entry(0, start_node));
+    while (!q.empty()) {
+        size_t node = std::get<1>(q.top());
+        q.pop();
+        settled[node] = true;
+        for (const auto& edge : graph.outgoing_edges(node)) {
+            double distance = distances[node] + edge.cost;
+            if (!settled[edge.destination] && distance < distances[edge.destination]) {
+                distances[edge.destination] = distance;
+                if (handles[edge.destination] == queue::handle_type()) {
+                    handles[edge.destination] = q.push(entry(distance, edge.destination));
+                } else {
+                    q.update(handles[edge.destination], entry(distance, edge.destination));
+                }
+            }
+        }
+    }
+    return distances;
+}
+
+// Returns the fastest of the runs in milliseconds.
+template <typename Fun> double measure(int repetitions, const Fun& fn) {
+    double best = INFINITY;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        best = std::min(best, duration.count());
+    }
+    return best;
+}
+
+void benchmark(const std::string& name, const sssp::graph& graph, int repetitions) {
+    std::cout << name << ": " << graph.node_count() << " nodes, " << graph.edge_count() << " edges\n";
+
+    sssp::node_map<double> reference;
+    sssp::node_map<double> result;
+    double pairing = measure(repetitions, [&] { reference = pairing_heap_distances(graph, 0); });
+    double radix = measure(repetitions, [&] { result = sssp::shortest_distances(graph, 0); });
+    if (result != reference) {
+        std::cout << "  the distances of both queues differ\n";
+    }
+    double criteria = measure(repetitions, [&] {
+        boost::base_collection<sssp::criteria> cs;
+        cs.insert(sssp::smallest_tentative_distance(&graph, 0));
+        sssp::dijkstra(graph, 0, cs);
+    });
+
+    auto row = [](const char* label, double ms) {
+        std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << ms << " ms";
+    };
+    row("pairing heap", pairing);
+    std::cout << "\n";
+    row("radix heap", radix);
+    std::cout << "  (" << std::setprecision(2) << pairing / radix << "x faster)\n";
+    row("dijkstra() with smallest_tentative_distance", criteria);
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    namespace po = boost::program_options;
+
+    int seed = 0;
+    size_t uniform_count = 10000;
+    double uniform_probability = 0.001;
+    int kronecker_k = 16;
+    int repetitions = 3;
+
+    // clang-format off
+    po::options_description opts("Compares the priority queues of Dijkstra's algorithm on a uniform and a Kronecker graph with uniformly random edge costs. Options");
+    opts.add_options()
+        ("help,h",
+            "Show this help message.")
+        ("seed", po::value(&seed)->default_value(seed),
+            "Set the seed of the generated graphs.")
+        ("uniform-count", po::value(&uniform_count)->default_value(uniform_count),
+            "Set the number of nodes of the uniform graph.")
+        ("uniform-probability", po::value(&uniform_probability)->default_value(uniform_probability),
+            "Set the edge probability of the uniform graph.")
+        ("kronecker-k", po::value(&kronecker_k)->default_value(kronecker_k),
+            "Set the number of iterations of the Kronecker graph, which has 2^k nodes.")
+        ("repetitions", po::value(&repetitions)->default_value(repetitions),
+            "Set how often each measurement is repeated, the fastest run counts.")
+        ;
+    // clang-format on
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, opts), vm);
+        if (vm.count("help")) {
+            std::cerr << "Usage: " << argv[0] << " [options]\n\n" << opts << "\n";
+            return EXIT_FAILURE;
+        }
+        po::notify(vm);
+    } catch (const po::error& ex) {
+        std::cerr << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 rng(seed);
+    sssp::edge_cost_fn edge_cost = [&](const sssp::line&) { return std::uniform_real_distribution<double>(0, 1)(rng); };
+
+    {
+        sssp::node_map<sssp::vec2> positions = sssp::generate_uniform_positions(seed, uniform_count);
+        sssp::graph_builder builder;
+        builder.add_nodes(positions.size());
+        sssp::generate_uniform_edges(seed, uniform_probability, edge_cost, builder, positions);
+        benchmark("uniform", builder.build(), repetitions);
+    }
+    {
+        sssp::node_map<sssp::vec2> positions;
+        sssp::graph_builder builder;
+        sssp::generate_kronecker_graph(seed, {0.9, 0.6, 0.6, 0.3}, kronecker_k, edge_cost, builder, positions);
+        benchmark("kronecker", builder.build(), repetitions);
+    }
+    return EXIT_SUCCESS;
+}
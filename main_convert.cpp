@@ -0,0 +1,73 @@
+#include "arguments.hpp"
+#include "graph_file.hpp"
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <iostream>
+
+template <typename Node, typename Cost>
+static int convert(const std::string& input, sssp::graph_format format, const std::string& output) {
+    sssp::basic_graph_builder<Node, Cost> builder;
+    if (!sssp::read_text_graph(input, format, builder, &std::cerr)) {
+        return EXIT_FAILURE;
+    }
+    const sssp::basic_graph<Node, Cost> graph = builder.build();
+    if (!sssp::write_binary_graph(output, graph, nullptr, &std::cerr)) {
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Wrote " << graph.node_count() << " nodes and " << graph.edge_count() << " edges to " << output
+              << ".\n";
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+    namespace po = boost::program_options;
+
+    std::string input;
+    std::string output;
+    sssp::graph_format format = sssp::graph_format::guess;
+    sssp::node_index_type node_type = sssp::node_index_type::uint64;
+    sssp::edge_cost_type cost_type = sssp::edge_cost_type::float64;
+
+    // clang-format off
+    po::options_description opts("Converts a text graph file (see `sssp-simulation --graph-file` and `--graph-format`) to a binary graph file that can be loaded without parsing. Options");
+    opts.add_options()
+        ("help,h",
+            "Show this help message.")
+        ("input", po::value(&input)->required(),
+            "The text graph file.")
+        ("format", po::value(&format)->default_value(format),
+            "Set the format of the text graph file (guess, edge_list, dimacs or metis).")
+        ("output", po::value(&output)->required(),
+            "The binary graph file to write.")
+        ("node-type", po::value(&node_type)->default_value(node_type),
+            "Set the integer type used for node indices (uint32 or uint64). The simulation has to use the same type.")
+        ("cost-type", po::value(&cost_type)->default_value(cost_type),
+            "Set the floating point type used for edge costs (float32 or float64). The simulation has to use the same type.")
+        ;
+    po::positional_options_description positional;
+    positional.add("input", 1).add("output", 1);
+    // clang-format on
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(opts).positional(positional).run(), vm);
+        if (vm.count("help")) {
+            std::cerr << "Usage: " << argv[0] << " INPUT OUTPUT\n\n" << opts << "\n";
+            return EXIT_FAILURE;
+        }
+        po::notify(vm);
+    } catch (const po::error& ex) {
+        std::cerr << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (node_type == sssp::node_index_type::uint32 && cost_type == sssp::edge_cost_type::float32) {
+        return convert<uint32_t, float>(input, format, output);
+    } else if (node_type == sssp::node_index_type::uint32) {
+        return convert<uint32_t, double>(input, format, output);
+    } else if (cost_type == sssp::edge_cost_type::float32) {
+        return convert<size_t, float>(input, format, output);
+    } else {
+        return convert<size_t, double>(input, format, output);
+    }
+}
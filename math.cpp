@@ -9,6 +9,18 @@ double sssp::distance(const vec2& a, const vec2& b) {
     return std::sqrt(dx * dx + dy * dy);
 }
 
+std::vector<double> sssp::distances_from(const vec2& origin, const std::vector<vec2>& positions) {
+    std::vector<double> distances(positions.size());
+    const vec2* p = positions.data();
+    double* d = distances.data();
+    for (size_t i = 0; i < positions.size(); ++i) {
+        double dx = origin.x - p[i].x;
+        double dy = origin.y - p[i].y;
+        d[i] = std::sqrt(dx * dx + dy * dy);
+    }
+    return distances;
+}
+
 bool sssp::intersects(const line& a, const line& b) {
     // First line:
     // x1 + lambda*s1
@@ -50,6 +50,8 @@ struct line {
 };
 
 double distance(const vec2& a, const vec2& b);
+// Returns distance(origin, p) for each position p, in one pass over the positions.
+std::vector<double> distances_from(const vec2& origin, const std::vector<vec2>& positions);
 bool intersects(const line& a, const line& b);
 
 } // namespace sssp
@@ -0,0 +1,104 @@
+#pragma once
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cstdlib>
+#include <vector>
+
+namespace sssp {
+
+// A set of nodes of a graph, e.g. the nodes to relax in a phase. A bitmap over all nodes
+// deduplicates the insertions and the nodes themselves are appended to a vector, thus inserting,
+// iterating and clearing never hash or allocate once the vector has grown.
+template <typename Node> class basic_node_set {
+  public:
+    using iterator = typename std::vector<Node>::const_iterator;
+
+    // Empty set for nodes from 0 to node_count - 1.
+    explicit basic_node_set(size_t node_count = 0) : m_contained(node_count, false) {}
+
+    // Inserts the node if it is not in the set yet.
+    void emplace(Node node) {
+        BOOST_ASSERT(node < m_contained.size());
+        if (!m_contained[node]) {
+            m_contained[node] = true;
+            m_nodes.push_back(node);
+        }
+    }
+    void insert(Node node) { emplace(node); }
+    template <typename Iter> void insert(Iter begin, Iter end) {
+        for (; begin != end; ++begin) {
+            emplace(*begin);
+        }
+    }
+
+    bool contains(Node node) const { return m_contained[node]; }
+    size_t size() const { return m_nodes.size(); }
+    bool empty() const { return m_nodes.empty(); }
+
+    // Removes all nodes, takes time linear in the size of the set and not in the number of nodes.
+    void clear() {
+        for (Node node : m_nodes) {
+            m_contained[node] = false;
+        }
+        m_nodes.clear();
+    }
+
+    // Sorts the nodes by index. Before, they are iterated in the order of insertion.
+    void sort() { std::sort(m_nodes.begin(), m_nodes.end()); }
+
+    iterator begin() const { return m_nodes.begin(); }
+    iterator end() const { return m_nodes.end(); }
+    const std::vector<Node>& nodes() const { return m_nodes; }
+
+  private:
+    std::vector<bool> m_contained;
+    std::vector<Node> m_nodes;
+};
+
+// A set of nodes that can also erase nodes in constant time. Instead of a bit, the position of
+// each node in the vector is stored. Erasing moves the last node to the free position, so the
+// order of the nodes changes.
+template <typename Node> class basic_erasable_node_set {
+  public:
+    using iterator = typename std::vector<Node>::const_iterator;
+
+    // Empty set for nodes from 0 to node_count - 1.
+    explicit basic_erasable_node_set(size_t node_count = 0) : m_position(node_count, Node(no_position)) {}
+
+    // Inserts the node if it is not in the set yet.
+    void insert(Node node) {
+        BOOST_ASSERT(node < m_position.size());
+        if (m_position[node] == no_position) {
+            m_position[node] = static_cast<Node>(m_nodes.size());
+            m_nodes.push_back(node);
+        }
+    }
+
+    // Erases the node if it is in the set.
+    void erase(Node node) {
+        Node position = m_position[node];
+        if (position != no_position) {
+            Node last = m_nodes.back();
+            m_nodes[position] = last;
+            m_position[last] = position;
+            m_nodes.pop_back();
+            m_position[node] = no_position;
+        }
+    }
+
+    bool contains(Node node) const { return m_position[node] != no_position; }
+    size_t size() const { return m_nodes.size(); }
+    bool empty() const { return m_nodes.empty(); }
+
+    iterator begin() const { return m_nodes.begin(); }
+    iterator end() const { return m_nodes.end(); }
+
+  private:
+    static constexpr Node no_position = Node(-1);
+
+    // The position of each node in m_nodes or no_position.
+    std::vector<Node> m_position;
+    std::vector<Node> m_nodes;
+};
+
+} // namespace sssp
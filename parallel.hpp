@@ -0,0 +1,74 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace sssp {
+
+// Returns the number of threads to use for parallel work, at least 1.
+inline size_t default_thread_count() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Splits [0, count) into thread_count contiguous blocks and calls fn(begin, end) for each block
+// in its own thread. The calling thread handles the first block. Blocks might be empty.
+template <typename Fun> void parallel_blocks(size_t count, size_t thread_count, const Fun& fn) {
+    thread_count = std::max<size_t>(1, std::min(thread_count, count));
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(
+            [&fn, count, thread_count, t] { fn(count * t / thread_count, count * (t + 1) / thread_count); });
+    }
+    fn(0, count / thread_count);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Calls fn(i) for each i in [0, count) using multiple threads.
+template <typename Fun> void parallel_for(size_t count, size_t thread_count, const Fun& fn) {
+    parallel_blocks(count, thread_count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn(i);
+        }
+    });
+}
+
+// Sorts the range using multiple threads: Each thread sorts a block, then the blocks are
+// merged pairwise. Like std::sort this is not stable.
+template <typename Iter, typename Compare>
+void parallel_sort(Iter begin, Iter end, const Compare& compare, size_t thread_count = default_thread_count()) {
+    // Below this size starting threads costs more than it saves.
+    static constexpr size_t min_block_size = 1 << 14;
+
+    size_t count = std::distance(begin, end);
+    thread_count = std::max<size_t>(1, std::min(thread_count, count / min_block_size));
+    if (thread_count == 1) {
+        std::sort(begin, end, compare);
+        return;
+    }
+
+    std::vector<size_t> bounds(thread_count + 1);
+    for (size_t t = 0; t <= thread_count; ++t) {
+        bounds[t] = count * t / thread_count;
+    }
+    parallel_for(
+        thread_count, thread_count, [&](size_t t) { std::sort(begin + bounds[t], begin + bounds[t + 1], compare); });
+
+    for (size_t width = 1; width < thread_count; width *= 2) {
+        size_t merges = (thread_count + 2 * width - 1) / (2 * width);
+        parallel_for(merges, merges, [&](size_t m) {
+            size_t first = 2 * width * m;
+            size_t middle = std::min(first + width, thread_count);
+            size_t last = std::min(first + 2 * width, thread_count);
+            if (middle < last) {
+                std::inplace_merge(begin + bounds[first], begin + bounds[middle], begin + bounds[last], compare);
+            }
+        });
+    }
+}
+
+} // namespace sssp
@@ -1,23 +1,423 @@
 #pragma once
-#include <set>
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <ostream>
+#include <vector>
 
 namespace sssp {
 
-template <typename T, typename Compare = std::less<T>, typename Allocator = std::allocator<T>> class priority_queue {
-    // std::set has the performance characteristics of a balanced tree in C++
-    using storage = std::set<T, Compare, Allocator>;
+// An array based d-ary min-heap of the items 0 to capacity - 1, usually nodes, each with a key.
+// The position of each item in the heap is stored, so the key of an item can be changed and an
+// item can be erased without handles. Items with equal keys are ordered by their index.
+template <typename Key, typename Item = size_t, typename Compare = std::less<Key>, size_t Arity = 4>
+class priority_queue {
+    static_assert(Arity >= 2, "a heap needs at least two children per item");
 
   public:
-    using handle_type = storage::iterator;
+    explicit priority_queue(size_t capacity = 0, const Compare& compare = Compare())
+        : m_position(capacity, Item(no_position)), m_compare(compare) {}
 
-    handle_type push(const T& item) { return m_items.insert(item); }
+    bool empty() const { return m_heap.empty(); }
+    size_t size() const { return m_heap.size(); }
+    bool contains(Item item) const { return m_position[item] != no_position; }
+    const Key& key(Item item) const {
+        BOOST_ASSERT(contains(item));
+        return m_heap[m_position[item]].key;
+    }
 
-    void erase(const handle_type& handle) { m_items.erase(item); }
+    // Returns the item with the smallest key.
+    Item top() const {
+        BOOST_ASSERT(!empty());
+        return m_heap.front().item;
+    }
+    const Key& top_key() const {
+        BOOST_ASSERT(!empty());
+        return m_heap.front().key;
+    }
 
-    void update(const handle_type& handle) { m_items.insert(m_items.extract(handle)); }
+    void push(Item item, const Key& key) {
+        BOOST_ASSERT(!contains(item));
+        m_heap.push_back(entry{key, item});
+        sift_up(m_heap.size() - 1);
+    }
+
+    // Changes the key of the item to a smaller or equal one.
+    void decrease(Item item, const Key& key) {
+        BOOST_ASSERT(contains(item) && !m_compare(m_heap[m_position[item]].key, key));
+        m_heap[m_position[item]].key = key;
+        sift_up(m_position[item]);
+    }
+
+    // Changes the key of the item to a greater or equal one.
+    void increase(Item item, const Key& key) {
+        BOOST_ASSERT(contains(item) && !m_compare(key, m_heap[m_position[item]].key));
+        m_heap[m_position[item]].key = key;
+        sift_down(m_position[item]);
+    }
+
+    // Changes the key of the item in either direction.
+    void update(Item item, const Key& key) {
+        BOOST_ASSERT(contains(item));
+        if (m_compare(key, m_heap[m_position[item]].key)) {
+            decrease(item, key);
+        } else {
+            increase(item, key);
+        }
+    }
+
+    void erase(Item item) {
+        BOOST_ASSERT(contains(item));
+        size_t position = m_position[item];
+        m_position[item] = no_position;
+        entry last = m_heap.back();
+        m_heap.pop_back();
+        if (position < m_heap.size()) {
+            m_heap[position] = last;
+            m_position[last.item] = static_cast<Item>(position);
+            sift_up(position);
+            sift_down(m_position[last.item]);
+        }
+    }
+
+    Item pop() {
+        Item item = top();
+        erase(item);
+        return item;
+    }
+
+    void clear() {
+        for (const entry& e : m_heap) {
+            m_position[e.item] = no_position;
+        }
+        m_heap.clear();
+    }
+
+    // Calls fn with each item whose key is not greater than the bound, in the order of the keys.
+    // Only the visited items and their children are looked at.
+    template <typename Fun> void for_each_up_to(const Key& bound, const Fun& fn) const {
+        if (empty() || m_compare(bound, m_heap.front().key)) {
+            return;
+        }
+        // A binary heap of the positions of the candidates, the children of the visited items.
+        auto after = [&](size_t a, size_t b) { return before(m_heap[b], m_heap[a]); };
+        std::vector<size_t> candidates = {0};
+        while (!candidates.empty()) {
+            std::pop_heap(candidates.begin(), candidates.end(), after);
+            size_t position = candidates.back();
+            candidates.pop_back();
+            fn(m_heap[position].item);
+
+            size_t end = std::min(first_child(position) + Arity, m_heap.size());
+            for (size_t child = first_child(position); child < end; ++child) {
+                if (!m_compare(bound, m_heap[child].key)) {
+                    candidates.push_back(child);
+                    std::push_heap(candidates.begin(), candidates.end(), after);
+                }
+            }
+        }
+    }
+
+    // Calls fn with each item whose key is not greater than the bound in heap order. These items
+    // form a subtree at the top of the heap, which is walked by the positions alone, so this takes
+    // time linear in the number of items found and does not allocate.
+    template <typename Fun> void for_each_unordered_up_to(const Key& bound, const Fun& fn) const {
+        if (empty() || m_compare(bound, m_heap.front().key)) {
+            return;
+        }
+        size_t position = 0;
+        while (true) {
+            if (!m_compare(bound, m_heap[position].key)) {
+                fn(m_heap[position].item);
+                if (first_child(position) < m_heap.size()) {
+                    position = first_child(position);
+                    continue;
+                }
+            }
+            // Go to the next sibling of the position or of its closest ancestor that has one.
+            while (position != 0 && (position % Arity == 0 || position + 1 >= m_heap.size())) {
+                position = (position - 1) / Arity;
+            }
+            if (position == 0) {
+                return;
+            }
+            ++position;
+        }
+    }
 
   private:
-    storage m_items;
+    static constexpr Item no_position = Item(-1);
+
+    struct entry {
+        Key key;
+        Item item;
+    };
+
+    static size_t first_child(size_t position) { return position * Arity + 1; }
+
+    bool before(const entry& a, const entry& b) const {
+        return m_compare(a.key, b.key) || (!m_compare(b.key, a.key) && a.item < b.item);
+    }
+
+    void sift_up(size_t position) {
+        entry moving = m_heap[position];
+        while (position > 0) {
+            size_t parent = (position - 1) / Arity;
+            if (!before(moving, m_heap[parent])) {
+                break;
+            }
+            move(parent, position);
+            position = parent;
+        }
+        place(moving, position);
+    }
+
+    void sift_down(size_t position) {
+        entry moving = m_heap[position];
+        while (first_child(position) < m_heap.size()) {
+            size_t end = std::min(first_child(position) + Arity, m_heap.size());
+            size_t best = first_child(position);
+            for (size_t child = best + 1; child < end; ++child) {
+                if (before(m_heap[child], m_heap[best])) {
+                    best = child;
+                }
+            }
+            if (!before(m_heap[best], moving)) {
+                break;
+            }
+            move(best, position);
+            position = best;
+        }
+        place(moving, position);
+    }
+
+    void move(size_t from, size_t to) {
+        m_heap[to] = m_heap[from];
+        m_position[m_heap[to].item] = static_cast<Item>(to);
+    }
+
+    void place(const entry& e, size_t position) {
+        m_heap[position] = e;
+        m_position[e.item] = static_cast<Item>(position);
+    }
+
+    std::vector<entry> m_heap;
+    // The position of each item in m_heap or no_position.
+    std::vector<Item> m_position;
+    Compare m_compare;
 };
 
+// Counts the work of a lazy_priority_queue.
+struct lazy_queue_counters {
+    // Entries put into the heap by push() and by update() with a new key.
+    size_t pushes = 0;
+    // Calls of update() with the current key, which an indexed heap would have to sift anyway.
+    size_t unchanged = 0;
+    // Entries of erased items or of outdated keys that were dropped.
+    size_t stale = 0;
+};
+
+// A d-ary min-heap of the items 0 to capacity - 1 with the interface of priority_queue, which
+// does not move entries when a key changes. It pushes a new entry with a new version instead,
+// and only if the key really changed. Erased items and outdated keys leave stale entries behind,
+// which are dropped once they reach the top or when they outnumber the valid ones. This pays off
+// when keys are updated often but rarely change.
+template <typename Key, typename Item = size_t, typename Compare = std::less<Key>, size_t Arity = 4>
+class lazy_priority_queue {
+    static_assert(Arity >= 2, "a heap needs at least two children per item");
+
+  public:
+    explicit lazy_priority_queue(size_t capacity = 0, const Compare& compare = Compare())
+        : m_items(capacity), m_compare(compare) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    bool contains(Item item) const { return m_items[item].contained; }
+    const Key& key(Item item) const {
+        BOOST_ASSERT(contains(item));
+        return m_items[item].key;
+    }
+    const lazy_queue_counters& counters() const { return m_counters; }
+
+    // Returns the item with the smallest key.
+    Item top() const {
+        BOOST_ASSERT(!empty());
+        return m_heap.front().item;
+    }
+    const Key& top_key() const {
+        BOOST_ASSERT(!empty());
+        return m_heap.front().key;
+    }
+
+    void push(Item item, const Key& key) {
+        BOOST_ASSERT(!contains(item));
+        m_items[item].contained = true;
+        ++m_size;
+        set_key(item, key);
+    }
+
+    // Changes the key of the item in either direction.
+    void update(Item item, const Key& key) {
+        BOOST_ASSERT(contains(item));
+        if (!m_compare(key, m_items[item].key) && !m_compare(m_items[item].key, key)) {
+            ++m_counters.unchanged;
+            return;
+        }
+        set_key(item, key);
+    }
+
+    void erase(Item item) {
+        BOOST_ASSERT(contains(item));
+        m_items[item].contained = false;
+        ++m_items[item].version;
+        --m_size;
+        drop_stale();
+    }
+
+    Item pop() {
+        Item item = top();
+        erase(item);
+        return item;
+    }
+
+    // Calls fn with each item whose key is not greater than the bound in heap order, see
+    // priority_queue::for_each_unordered_up_to. Stale entries are skipped.
+    template <typename Fun> void for_each_unordered_up_to(const Key& bound, const Fun& fn) const {
+        if (empty() || m_compare(bound, m_heap.front().key)) {
+            return;
+        }
+        size_t position = 0;
+        while (true) {
+            if (!m_compare(bound, m_heap[position].key)) {
+                if (valid(m_heap[position])) {
+                    fn(m_heap[position].item);
+                }
+                if (first_child(position) < m_heap.size()) {
+                    position = first_child(position);
+                    continue;
+                }
+            }
+            while (position != 0 && (position % Arity == 0 || position + 1 >= m_heap.size())) {
+                position = (position - 1) / Arity;
+            }
+            if (position == 0) {
+                return;
+            }
+            ++position;
+        }
+    }
+
+  private:
+    struct item_state {
+        Key key = Key();
+        // Only the entry with the current version of a contained item is valid.
+        uint32_t version = 0;
+        bool contained = false;
+    };
+
+    struct entry {
+        Key key;
+        Item item;
+        uint32_t version;
+    };
+
+    static size_t first_child(size_t position) { return position * Arity + 1; }
+
+    bool valid(const entry& e) const { return m_items[e.item].contained && m_items[e.item].version == e.version; }
+
+    bool before(const entry& a, const entry& b) const {
+        return m_compare(a.key, b.key) || (!m_compare(b.key, a.key) && a.item < b.item);
+    }
+
+    void set_key(Item item, const Key& key) {
+        item_state& state = m_items[item];
+        state.key = key;
+        ++state.version;
+        ++m_counters.pushes;
+        m_heap.push_back(entry{key, item, state.version});
+        sift_up(m_heap.size() - 1);
+        drop_stale();
+    }
+
+    // Keeps a valid entry at the top and rebuilds the heap once most entries are stale.
+    void drop_stale() {
+        if (m_heap.size() > 2 * m_size + 64) {
+            size_t valid_count = 0;
+            for (const entry& e : m_heap) {
+                if (valid(e)) {
+                    m_heap[valid_count++] = e;
+                }
+            }
+            m_counters.stale += m_heap.size() - valid_count;
+            m_heap.resize(valid_count);
+            for (size_t position = m_heap.size() / Arity + 1; position-- > 0;) {
+                if (first_child(position) < m_heap.size()) {
+                    sift_down(position);
+                }
+            }
+        }
+        while (!m_heap.empty() && !valid(m_heap.front())) {
+            ++m_counters.stale;
+            m_heap.front() = m_heap.back();
+            m_heap.pop_back();
+            if (!m_heap.empty()) {
+                sift_down(0);
+            }
+        }
+    }
+
+    void sift_up(size_t position) {
+        entry moving = m_heap[position];
+        while (position > 0) {
+            size_t parent = (position - 1) / Arity;
+            if (!before(moving, m_heap[parent])) {
+                break;
+            }
+            m_heap[position] = m_heap[parent];
+            position = parent;
+        }
+        m_heap[position] = moving;
+    }
+
+    void sift_down(size_t position) {
+        entry moving = m_heap[position];
+        while (first_child(position) < m_heap.size()) {
+            size_t end = std::min(first_child(position) + Arity, m_heap.size());
+            size_t best = first_child(position);
+            for (size_t child = best + 1; child < end; ++child) {
+                if (before(m_heap[child], m_heap[best])) {
+                    best = child;
+                }
+            }
+            if (!before(m_heap[best], moving)) {
+                break;
+            }
+            m_heap[position] = m_heap[best];
+            position = best;
+        }
+        m_heap[position] = moving;
+    }
+
+    std::vector<entry> m_heap;
+    std::vector<item_state> m_items;
+    // The number of contained items, i.e. of valid entries.
+    size_t m_size = 0;
+    Compare m_compare;
+    lazy_queue_counters m_counters;
+};
+
+// Writes the counters of a lazy queue as a line starting with the name, nothing for other queues.
+template <typename Queue> void print_queue_counters(std::ostream& out, const char* name, const Queue& queue) {}
+
+template <typename Key, typename Item, typename Compare, size_t Arity>
+void print_queue_counters(std::ostream& out,
+                          const char* name,
+                          const lazy_priority_queue<Key, Item, Compare, Arity>& queue) {
+    const lazy_queue_counters& c = queue.counters();
+    out << name << ": " << c.pushes << " entries pushed, " << c.unchanged << " updates with unchanged key skipped, "
+        << c.stale << " stale entries dropped\n";
+}
+
 } // namespace sssp
@@ -0,0 +1,168 @@
+#include "radius_stepping.hpp"
+#include "graph_index.hpp"
+#include "node_set.hpp"
+#include "parallel.hpp"
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <boost/assert.hpp>
+
+template <typename Node, typename Cost>
+sssp::node_map<Cost> sssp::ball_radii(const basic_graph<Node, Cost>& graph, size_t rho, size_t thread_count) {
+    BOOST_ASSERT(rho > 0);
+    const basic_graph_index<Node, Cost>& index = graph.index();
+    node_map<Cost> radii(graph.node_count(), INFINITY);
+    parallel_blocks(graph.node_count(), thread_count, [&](size_t begin, size_t end) {
+        // Reused by all searches of the thread, only the reached nodes are reset after each one.
+        std::vector<Cost> distances(graph.node_count(), INFINITY);
+        std::vector<Node> reached;
+        priority_queue<Cost, Node> queue(graph.node_count());
+        // The destinations seen while scanning the edges of a node, by the number of the scan.
+        std::vector<size_t> seen(graph.node_count(), 0);
+        size_t scan = 0;
+
+        for (size_t source = begin; source < end; ++source) {
+            size_t settled = 0;
+            distances[source] = 0;
+            reached.push_back(static_cast<Node>(source));
+            queue.push(static_cast<Node>(source), 0);
+            while (!queue.empty()) {
+                Cost distance = queue.top_key();
+                Node node = queue.pop();
+                if (node != source && ++settled == rho) {
+                    radii[source] = distance;
+                    break;
+                }
+                // The edges are sorted by cost. Once they led to rho distinct nodes other than the
+                // source, the remaining ones cannot lower the distance of the rho-th nearest node.
+                size_t distinct = 0;
+                scan += 1;
+                for (const auto& edge : index.outgoing(node)) {
+                    if (distinct == rho) {
+                        break;
+                    }
+                    if (edge.node != source && seen[edge.node] != scan) {
+                        seen[edge.node] = scan;
+                        distinct += 1;
+                    }
+                    Cost new_distance = distance + edge.cost;
+                    if (new_distance < distances[edge.node]) {
+                        if (distances[edge.node] == INFINITY) {
+                            reached.push_back(edge.node);
+                            queue.push(edge.node, new_distance);
+                        } else {
+                            queue.decrease(edge.node, new_distance);
+                        }
+                        distances[edge.node] = new_distance;
+                    }
+                }
+            }
+
+            queue.clear();
+            for (Node node : reached) {
+                distances[node] = INFINITY;
+            }
+            reached.clear();
+        }
+    });
+    return radii;
+}
+
+template <typename Node, typename Cost>
+sssp::basic_label_correcting_result<Node, Cost>
+sssp::radius_stepping(const basic_graph<Node, Cost>& graph, size_t start_node, const node_map<Cost>& radii) {
+    basic_label_correcting_result<Node, Cost> result;
+    node_map<basic_dijkstra_result<Node, Cost>>& info = result.nodes;
+    info = graph.make_node_map([](size_t i) { return basic_dijkstra_result<Node, Cost>(); });
+
+    // The fringe nodes by tentative distance and by tentative distance plus radius. Nodes relaxed
+    // in the current step stay in the queues until the step ends.
+    priority_queue<Cost, Node> distance_queue(graph.node_count());
+    priority_queue<Cost, Node> bound_queue(graph.node_count());
+    // The bound of the current step, the nodes to relax in the next phase of the step and the
+    // nodes waiting to be relaxed with their current distance.
+    Cost bound = -INFINITY;
+    basic_node_set<Node> next(graph.node_count());
+    std::vector<bool> waiting(graph.node_count(), false);
+    size_t waiting_count = 0;
+    auto improve = [&](Node node, Node predecessor, Cost distance) {
+        BOOST_ASSERT(distance_queue.contains(node) || info[node].distance == INFINITY);
+        info[node].distance = distance;
+        info[node].predecessor = predecessor;
+        if (distance_queue.contains(node)) {
+            distance_queue.decrease(node, distance);
+            bound_queue.decrease(node, distance + radii[node]);
+        } else {
+            distance_queue.push(node, distance);
+            bound_queue.push(node, distance + radii[node]);
+        }
+        if (!waiting[node]) {
+            waiting[node] = true;
+            waiting_count += 1;
+        }
+        if (distance <= bound) {
+            next.insert(node);
+        }
+    };
+
+    // The relaxations of a phase are computed from the distances at its start and applied after.
+    struct request {
+        Node node;
+        Node predecessor;
+        Cost distance;
+    };
+    std::vector<request> requests;
+
+    improve(static_cast<Node>(start_node), Node(-1), 0);
+
+    std::vector<bool> relaxed_before(graph.node_count(), false);
+    std::vector<Node> nodes;
+    int phase = 0;
+    while (!distance_queue.empty()) {
+        bound = bound_queue.top_key();
+        distance_queue.for_each_unordered_up_to(bound, [&](Node node) { next.insert(node); });
+
+        while (!next.empty()) {
+            next.sort();
+            nodes.assign(next.begin(), next.end());
+            next.clear();
+
+            label_correcting_phase stats;
+            stats.relaxed = nodes.size();
+            stats.fringe_size = waiting_count;
+            for (Node node : nodes) {
+                info[node].relaxation_phase = phase;
+                info[node].fringe_size = stats.fringe_size;
+                if (relaxed_before[node]) {
+                    stats.rerelaxed += 1;
+                }
+                relaxed_before[node] = true;
+                waiting[node] = false;
+                waiting_count -= 1;
+                for (const auto& edge : graph.outgoing_edges(node)) {
+                    requests.push_back(request{edge.destination, node, info[node].distance + edge.cost});
+                }
+            }
+            for (const request& r : requests) {
+                if (r.distance < info[r.node].distance) {
+                    improve(r.node, r.predecessor, r.distance);
+                }
+            }
+            requests.clear();
+            result.phases.push_back(stats);
+            ++phase;
+        }
+
+        // No node up to the bound improved in the last phase, their distances are final.
+        while (!distance_queue.empty() && distance_queue.top_key() <= bound) {
+            bound_queue.erase(distance_queue.pop());
+        }
+    }
+
+    return result;
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template sssp::node_map<COST> sssp::ball_radii(const basic_graph<NODE, COST>&, size_t, size_t);                    \
+    template sssp::basic_label_correcting_result<NODE, COST> sssp::radius_stepping(                                    \
+        const basic_graph<NODE, COST>&, size_t, const node_map<COST>&);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -0,0 +1,24 @@
+#pragma once
+#include "graph.hpp"
+#include "label_correcting.hpp"
+
+namespace sssp {
+
+// Returns the radius of each node for radius_stepping(): the distance to its rho-th nearest other
+// node, infinity if fewer nodes are reachable. Each node runs a Dijkstra search that stops after
+// rho nodes and only scans the cheapest edges of each node that lead to rho distinct nodes. The
+// searches are split between the threads.
+template <typename Node, typename Cost>
+node_map<Cost> ball_radii(const basic_graph<Node, Cost>& graph, size_t rho, size_t thread_count);
+
+// Runs the radius-stepping of Blelloch, Gu, Sun and Tangwongsan, which is label correcting like
+// delta_stepping(). Each step computes the bound d = min{ tentative(n) + radius(n) : n in the
+// fringe }. Its first phase relaxes the fringe nodes n with tentative(n) <= d with the distances
+// at the start of the phase, each following phase the nodes that improved to at most d in the
+// previous one. Once no node improves anymore, the nodes up to d are settled and the next step
+// starts. The paper also adds shortcut edges to bound the phases of a step, this does not.
+template <typename Node, typename Cost>
+basic_label_correcting_result<Node, Cost>
+radius_stepping(const basic_graph<Node, Cost>& graph, size_t start_node, const node_map<Cost>& radii);
+
+} // namespace sssp
@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace sssp {
+
+// A priority queue of the nodes of a graph keyed by non-negative costs, which are compared by
+// their IEEE 754 bit patterns. Those are ordered like the numbers themselves, so each node is kept
+// in the bucket of the highest bit in which its key differs from the last minimum. Only the lowest
+// non-empty bucket is redistributed when the nodes with the minimal key are gone, which makes the
+// operations amortized constant time with little pointer chasing. Ties are broken by the node
+// index. The keys should not be smaller than the minimum at the time they are pushed, as it holds
+// for the tentative distances in Dijkstra's algorithm, otherwise all nodes are redistributed.
+template <typename Node, typename Cost> class radix_heap {
+    using bits_type = std::conditional_t<sizeof(Cost) <= sizeof(uint32_t), uint32_t, uint64_t>;
+    static constexpr uint8_t bucket_count = sizeof(bits_type) * 8 + 1;
+    static constexpr uint8_t no_bucket = uint8_t(-1);
+
+  public:
+    explicit radix_heap(size_t node_count = 0)
+        : m_keys(node_count), m_bucket(node_count, uint8_t(no_bucket)), m_slot(node_count), m_buckets(bucket_count) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    bool contains(Node node) const { return m_bucket[node] != no_bucket; }
+    Cost key(Node node) const { return m_keys[node]; }
+
+    // Returns the node with the smallest key and the smallest index among those.
+    Node top() const {
+        BOOST_ASSERT(!empty());
+        return m_minimum.front();
+    }
+
+    // Inserts the node or changes its key.
+    void push(Node node, Cost key) {
+        if (contains(node)) {
+            detach(node);
+        }
+        bits_type bits = to_bits(key);
+        if (m_size == 0) {
+            m_last = bits;
+        } else if (bits < m_last) {
+            rebase(bits);
+        }
+        m_keys[node] = key;
+        place(node, bits);
+        ++m_size;
+        restore();
+    }
+
+    void erase(Node node) {
+        BOOST_ASSERT(contains(node));
+        detach(node);
+        restore();
+    }
+
+    Node pop() {
+        Node node = top();
+        erase(node);
+        return node;
+    }
+
+  private:
+    static bits_type to_bits(Cost key) {
+        BOOST_ASSERT(key >= 0);
+        // Adding zero turns -0 into +0.
+        key += Cost(0);
+        bits_type bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    static uint8_t bit_width(bits_type x) {
+        uint8_t width = 0;
+        for (uint8_t shift = sizeof(bits_type) * 4; shift > 0; shift /= 2) {
+            if ((x >> shift) != 0) {
+                x >>= shift;
+                width += shift;
+            }
+        }
+        return width + static_cast<uint8_t>(x);
+    }
+
+    // Puts the node in its bucket. Bucket 0 contains the nodes whose key equals the last minimum,
+    // it is a binary heap ordered by the node index.
+    void place(Node node, bits_type bits) {
+        uint8_t bucket = bit_width(bits ^ m_last);
+        m_bucket[node] = bucket;
+        if (bucket == 0) {
+            m_minimum.push_back(node);
+            std::push_heap(m_minimum.begin(), m_minimum.end(), std::greater<Node>());
+            ++m_minimum_count;
+        } else {
+            m_slot[node] = static_cast<Node>(m_buckets[bucket].size());
+            m_buckets[bucket].push_back(node);
+        }
+    }
+
+    // Takes the node out of its bucket. The entries of bucket 0 are removed lazily by restore().
+    void detach(Node node) {
+        uint8_t bucket = m_bucket[node];
+        if (bucket == 0) {
+            --m_minimum_count;
+        } else {
+            std::vector<Node>& nodes = m_buckets[bucket];
+            Node last = nodes.back();
+            nodes[m_slot[node]] = last;
+            m_slot[last] = m_slot[node];
+            nodes.pop_back();
+        }
+        m_bucket[node] = no_bucket;
+        --m_size;
+    }
+
+    // Makes the top of bucket 0 valid again and refills it from the lowest non-empty bucket once
+    // it ran empty.
+    void restore() {
+        while (!m_minimum.empty() && m_bucket[m_minimum.front()] != 0) {
+            std::pop_heap(m_minimum.begin(), m_minimum.end(), std::greater<Node>());
+            m_minimum.pop_back();
+        }
+        if (m_minimum_count > 0 || m_size == 0) {
+            return;
+        }
+        m_minimum.clear();
+
+        uint8_t bucket = 1;
+        while (m_buckets[bucket].empty()) {
+            ++bucket;
+        }
+        std::vector<Node> nodes;
+        nodes.swap(m_buckets[bucket]);
+        m_last = to_bits(m_keys[*std::min_element(
+            nodes.begin(), nodes.end(), [&](Node a, Node b) { return m_keys[a] < m_keys[b]; })]);
+        // All nodes go to lower buckets, the ones with the new minimum to bucket 0.
+        for (Node node : nodes) {
+            place(node, to_bits(m_keys[node]));
+        }
+    }
+
+    // Redistributes all nodes for a new minimum below the last one.
+    void rebase(bits_type bits) {
+        std::vector<Node> nodes;
+        nodes.reserve(m_size);
+        for (Node node : m_minimum) {
+            if (m_bucket[node] == 0) {
+                // Marks duplicate entries as removed.
+                m_bucket[node] = no_bucket;
+                nodes.push_back(node);
+            }
+        }
+        m_minimum.clear();
+        m_minimum_count = 0;
+        for (uint8_t bucket = 1; bucket < bucket_count; ++bucket) {
+            nodes.insert(nodes.end(), m_buckets[bucket].begin(), m_buckets[bucket].end());
+            m_buckets[bucket].clear();
+        }
+        m_last = bits;
+        for (Node node : nodes) {
+            place(node, to_bits(m_keys[node]));
+        }
+    }
+
+    std::vector<Cost> m_keys;
+    std::vector<uint8_t> m_bucket;
+    // Position of each node in its bucket, unused for bucket 0.
+    std::vector<Node> m_slot;
+    std::vector<std::vector<Node>> m_buckets;
+    // Bucket 0, may contain nodes that were removed since.
+    std::vector<Node> m_minimum;
+    size_t m_minimum_count = 0;
+    size_t m_size = 0;
+    bits_type m_last = 0;
+};
+
+} // namespace sssp
@@ -0,0 +1,162 @@
+#include "reorder_nodes.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <tuple>
+
+// Returns the position of the cell x/y on a Hilbert curve through a grid of side length n,
+// n has to be a power of two.
+static uint64_t hilbert_index(uint64_t n, uint64_t x, uint64_t y) {
+    uint64_t index = 0;
+    for (uint64_t s = n / 2; s > 0; s /= 2) {
+        uint64_t rx = (x & s) > 0 ? 1 : 0;
+        uint64_t ry = (y & s) > 0 ? 1 : 0;
+        index += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so that the curve inside of it starts and ends at the right corners.
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+sssp::node_order sssp::hilbert_order(const node_map<vec2>& positions) {
+    // 2^16 cells per side are plenty for the number of nodes the simulation can handle.
+    const uint64_t n = uint64_t(1) << 16;
+    auto cell = [&](double v) { return static_cast<uint64_t>(std::min(std::max(v, 0.0), 1.0) * (n - 1)); };
+
+    std::vector<std::tuple<uint64_t, size_t>> keys(positions.size());
+    parallel_for(positions.size(), default_thread_count(), [&](size_t node) {
+        keys[node] = std::make_tuple(hilbert_index(n, cell(positions[node].x), cell(positions[node].y)), node);
+    });
+    // The node index makes the keys unique, so the unstable sort is deterministic.
+    parallel_sort(keys.begin(), keys.end(), std::less<std::tuple<uint64_t, size_t>>());
+
+    node_order order(positions.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        order[i] = std::get<1>(keys[i]);
+    }
+    return order;
+}
+
+template <typename Node, typename Cost>
+sssp::node_order sssp::bfs_order(const basic_graph<Node, Cost>& graph, size_t start_node) {
+    node_order order;
+    order.reserve(graph.node_count());
+    std::vector<bool> visited(graph.node_count(), false);
+
+    auto search = [&](size_t root) {
+        // The order itself is the queue of the search.
+        size_t head = order.size();
+        visited[root] = true;
+        order.push_back(root);
+        while (head < order.size()) {
+            size_t node = order[head++];
+            for (const auto& edge : graph.outgoing_edges(node)) {
+                if (!visited[edge.destination]) {
+                    visited[edge.destination] = true;
+                    order.push_back(edge.destination);
+                }
+            }
+            for (const auto& edge : graph.incoming_edges(node)) {
+                if (!visited[edge.source]) {
+                    visited[edge.source] = true;
+                    order.push_back(edge.source);
+                }
+            }
+        }
+    };
+
+    if (graph.node_count() > 0) {
+        search(start_node);
+    }
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        if (!visited[node]) {
+            search(node);
+        }
+    }
+    return order;
+}
+
+template <typename Node, typename Cost> sssp::node_order sssp::rcm_order(const basic_graph<Node, Cost>& graph) {
+    node_map<size_t> degree = graph.make_node_map(
+        [&](size_t node) { return graph.outgoing_edges(node).size() + graph.incoming_edges(node).size(); });
+    auto by_degree = [&](size_t a, size_t b) { return std::tie(degree[a], a) < std::tie(degree[b], b); };
+
+    // Candidates for the start of each component, the first unvisited one is used.
+    std::vector<size_t> roots(graph.node_count());
+    std::iota(roots.begin(), roots.end(), 0);
+    std::sort(roots.begin(), roots.end(), by_degree);
+
+    node_order order;
+    order.reserve(graph.node_count());
+    std::vector<bool> visited(graph.node_count(), false);
+    std::vector<size_t> neighbours;
+    for (size_t root : roots) {
+        if (visited[root]) {
+            continue;
+        }
+        size_t head = order.size();
+        visited[root] = true;
+        order.push_back(root);
+        while (head < order.size()) {
+            size_t node = order[head++];
+            neighbours.clear();
+            for (const auto& edge : graph.outgoing_edges(node)) {
+                if (!visited[edge.destination]) {
+                    visited[edge.destination] = true;
+                    neighbours.push_back(edge.destination);
+                }
+            }
+            for (const auto& edge : graph.incoming_edges(node)) {
+                if (!visited[edge.source]) {
+                    visited[edge.source] = true;
+                    neighbours.push_back(edge.source);
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end(), by_degree);
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+sssp::node_map<size_t> sssp::inverse_order(const node_order& order) {
+    node_map<size_t> result(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        result[order[i]] = i;
+    }
+    return result;
+}
+
+template <typename Node, typename Cost>
+sssp::basic_graph<Node, Cost> sssp::reorder_graph(const basic_graph<Node, Cost>& graph, const node_order& order) {
+    BOOST_ASSERT(order.size() == graph.node_count());
+    node_map<size_t> new_index = inverse_order(order);
+
+    basic_graph_builder<Node, Cost> builder;
+    builder.add_nodes(graph.node_count());
+    builder.reserve_edges(graph.edge_count());
+    for (size_t node = 0; node < graph.node_count(); ++node) {
+        for (const auto& edge : graph.outgoing_edges(node)) {
+            builder.add_edge(
+                static_cast<Node>(new_index[edge.source]), static_cast<Node>(new_index[edge.destination]), edge.cost);
+        }
+    }
+    return builder.build();
+}
+
+#define SSSP_INSTANTIATE(NODE, COST)                                                                                   \
+    template sssp::node_order sssp::bfs_order(const basic_graph<NODE, COST>&, size_t);                                 \
+    template sssp::node_order sssp::rcm_order(const basic_graph<NODE, COST>&);                                         \
+    template sssp::basic_graph<NODE, COST> sssp::reorder_graph(const basic_graph<NODE, COST>&, const node_order&);
+SSSP_FOR_EACH_GRAPH_TYPE(SSSP_INSTANTIATE)
@@ -0,0 +1,42 @@
+#pragma once
+#include "graph.hpp"
+#include "math.hpp"
+#include <vector>
+
+namespace sssp {
+
+// A node order is a permutation of the nodes of a graph: order[i] is the original index of the
+// node that gets the new index i. Reordering does not change the graph itself, it only improves
+// the memory locality of the node indices.
+using node_order = std::vector<size_t>;
+
+// Orders the nodes along a Hilbert curve through their positions, which have to be in the area
+// from 0/0 to 1/1. Nodes that are close to each other in the plane get close indices.
+node_order hilbert_order(const node_map<vec2>& positions);
+
+// Orders the nodes by a breadth first search from the start node ignoring edge directions.
+// Nodes that cannot be reached start new searches in the order of their index.
+template <typename Node, typename Cost> node_order bfs_order(const basic_graph<Node, Cost>& graph, size_t start_node);
+
+// Orders the nodes by the reverse Cuthill-McKee algorithm ignoring edge directions, which
+// reduces the bandwidth of the adjacency matrix. Each component starts at a node of minimal degree.
+template <typename Node, typename Cost> node_order rcm_order(const basic_graph<Node, Cost>& graph);
+
+// Returns the new index of each original node.
+node_map<size_t> inverse_order(const node_order& order);
+
+// Returns a copy of the graph with the nodes renamed according to the order.
+template <typename Node, typename Cost>
+basic_graph<Node, Cost> reorder_graph(const basic_graph<Node, Cost>& graph, const node_order& order);
+
+// Returns a copy of the node map with the entries rearranged according to the order.
+template <typename T> node_map<T> reorder_node_map(const node_map<T>& map, const node_order& order) {
+    node_map<T> result;
+    result.reserve(order.size());
+    for (size_t original : order) {
+        result.push_back(map[original]);
+    }
+    return result;
+}
+
+} // namespace sssp
@@ -6,13 +6,16 @@
 #include "crit_paper_in.hpp"
 #include "crit_paper_out.hpp"
 #include "crit_traff_bridge.hpp"
+#include "delta_stepping.hpp"
 #include "dijkstra.hpp"
+#include "dijkstra_engine.hpp"
 #include "generate_edges.hpp"
 #include "generate_positions.hpp"
+#include "graph_cache.hpp"
+#include "graph_file.hpp"
 #include "math.hpp"
-#include <boost/algorithm/string.hpp>
-#include <cctype>
-#include <fstream>
+#include "radius_stepping.hpp"
+#include "reorder_nodes.hpp"
 #include <random>
 
 #ifndef DISABLE_CAIRO
@@ -20,147 +23,251 @@
 #include <cairomm/cairomm.h>
 #endif
 
-using namespace boost::algorithm;
+const std::string sssp::dijkstra_result_csv_header("node_count,phase,relaxed,fringe_size,rerelaxed");
 
-const std::string sssp::dijkstra_result_csv_header("node_count,phase,relaxed,fringe_size");
+namespace {
 
-void sssp::execute_run(const arguments& args, std::ostream* out, std::ostream* err) {
-    size_t start_node = 0;
-    node_map<vec2> positions;
-    graph graph;
+using namespace sssp;
 
-    if (args.graph_file.empty()) {
-        std::mt19937_64 rng(args.seed);
-        std::uniform_int_distribution<int> uniform_seed(INT_MIN, INT_MAX);
-        int position_seed = uniform_seed(rng);
-        int cost_seed = uniform_seed(rng);
-        int edge_seed = uniform_seed(rng);
+// Prints an error and returns false if the graph has too many nodes for the node index type.
+template <typename Node, typename Cost>
+bool check_node_count(const arguments& args, size_t node_count, std::ostream* err) {
+    if (basic_graph_builder<Node, Cost>::can_index(node_count)) {
+        return true;
+    }
+    if (err) {
+        (*err) << "The graph has too many nodes for `--node-type " << args.types.node << "`!\n";
+    }
+    return false;
+}
 
-        if (args.edge_gen.algorithm != edge_algorithm::kronecker) {
-            switch (args.position_gen.algorithm) {
-                case position_algorithm::poisson:
-                    positions = generate_poisson_disc_positions(
-                        position_seed, args.position_gen.poisson.min_distance, args.position_gen.poisson.max_reject);
-                    break;
-                case position_algorithm::uniform:
-                    positions = generate_uniform_positions(position_seed, args.position_gen.uniform.count);
-                    break;
-                default:
-                    BOOST_ASSERT(false);
-                    break;
+// Creates the criteria of an algorithm and calls fn with it. The type of the criteria depends on
+// the algorithm and on --lazy-queues.
+template <typename Node, typename Cost, typename Fun>
+void with_criteria(const arguments& args,
+                   sssp_algorithm algorithm,
+                   const basic_graph<Node, Cost>& graph,
+                   size_t start_node,
+                   const node_map<vec2>& positions,
+                   const Fun& fn) {
+    using lazy_queue = lazy_priority_queue<Cost, Node>;
+    switch (algorithm) {
+        case sssp_algorithm::crauser_in:
+            fn(basic_crauser_in<Node, Cost>(&graph, start_node, false));
+            break;
+        case sssp_algorithm::crauser_in_dyn:
+            if (args.lazy_queues) {
+                fn(basic_crauser_in<Node, Cost, lazy_queue>(&graph, start_node, true));
+            } else {
+                fn(basic_crauser_in<Node, Cost>(&graph, start_node, true));
             }
-
-            for (size_t i = 0; i < positions.size(); ++i) {
-                graph.add_node();
+            break;
+        case sssp_algorithm::crauser_out:
+            fn(basic_crauser_out<Node, Cost>(&graph, start_node, false));
+            break;
+        case sssp_algorithm::crauser_out_dyn:
+            if (args.lazy_queues) {
+                fn(basic_crauser_out<Node, Cost, lazy_queue>(&graph, start_node, true));
+            } else {
+                fn(basic_crauser_out<Node, Cost>(&graph, start_node, true));
             }
+            break;
+        case sssp_algorithm::dijkstra:
+            fn(basic_smallest_tentative_distance<Node, Cost>(&graph, start_node));
+            break;
+        case sssp_algorithm::heuristic: {
+            // Underestimates the distances if the edge costs are at least the euclidean lengths.
+            std::vector<double> distances = distances_from(positions[start_node], positions);
+            fn(basic_heuristic<Node, Cost>(&graph, start_node, node_map<Cost>(distances.begin(), distances.end())));
+            break;
         }
+        case sssp_algorithm::oracle:
+            fn(basic_oracle<Node, Cost>(&graph, start_node));
+            break;
+        case sssp_algorithm::traff:
+            if (args.lazy_queues) {
+                fn(basic_traff_bridge<Node, Cost, lazy_queue>(&graph, start_node));
+            } else {
+                fn(basic_traff_bridge<Node, Cost>(&graph, start_node));
+            }
+            break;
+        case sssp_algorithm::paper_in:
+            fn(basic_paper_in<Node, Cost>(&graph, start_node));
+            break;
+        case sssp_algorithm::paper_out:
+            fn(basic_paper_out<Node, Cost>(&graph, start_node));
+            break;
+        default:
+            BOOST_ASSERT(false);
+            break;
+    }
+}
 
-        edge_cost_fn edge_cost_fn;
-        switch (args.cost_gen.algorithm) {
-            case cost_algorithm::uniform:
-                edge_cost_fn = [rng = std::mt19937(cost_seed)](const line& line) mutable {
-                    return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
-                };
-                break;
-            case cost_algorithm::one:
-                edge_cost_fn = [](const line& line) { return 1.0; };
+// Runs dijkstra() with criteria types known at compile time for the common cases: a single
+// algorithm and a single algorithm combined with Dijkstra's criteria. Returns false for all other
+// combinations, which have to use a collection of criteria. The counters of the criteria are
+// written to err.
+template <typename Node, typename Cost>
+bool run_static_dijkstra(const arguments& args,
+                         const basic_graph<Node, Cost>& graph,
+                         size_t start_node,
+                         const node_map<vec2>& positions,
+                         node_map<basic_dijkstra_result<Node, Cost>>& result,
+                         std::ostream* err) {
+    // The algorithms are sorted and unique, dijkstra comes first.
+    if (args.algorithms.size() == 1) {
+        with_criteria(args, args.algorithms[0], graph, start_node, positions, [&](auto&& crit) {
+            auto criteria = std::make_tuple(std::move(crit));
+            result = dijkstra(graph, start_node, criteria, args.threads);
+            if (err) {
+                std::get<0>(criteria).print_counters(*err);
+            }
+        });
+        return true;
+    } else if (args.algorithms.size() == 2 && args.algorithms[0] == sssp_algorithm::dijkstra) {
+        with_criteria(args, args.algorithms[1], graph, start_node, positions, [&](auto&& crit) {
+            auto criteria =
+                std::make_tuple(basic_smallest_tentative_distance<Node, Cost>(&graph, start_node), std::move(crit));
+            result = dijkstra(graph, start_node, criteria, args.threads);
+            if (err) {
+                std::get<1>(criteria).print_counters(*err);
+            }
+        });
+        return true;
+    }
+    return false;
+}
+
+// Generates the graph as requested by the arguments. Returns false on errors.
+template <typename Node, typename Cost>
+bool generate_graph(const arguments& args,
+                    basic_graph_builder<Node, Cost>& builder,
+                    node_map<vec2>& positions,
+                    std::ostream* err) {
+    std::mt19937_64 rng(args.seed);
+    std::uniform_int_distribution<int> uniform_seed(INT_MIN, INT_MAX);
+    int position_seed = uniform_seed(rng);
+    int cost_seed = uniform_seed(rng);
+    int edge_seed = uniform_seed(rng);
+
+    if (args.edge_gen.algorithm != edge_algorithm::kronecker) {
+        switch (args.position_gen.algorithm) {
+            case position_algorithm::poisson:
+                positions = generate_poisson_disc_positions(
+                    position_seed, args.position_gen.poisson.min_distance, args.position_gen.poisson.max_reject);
                 break;
-            case cost_algorithm::euclidean:
-                edge_cost_fn = [](const line& line) { return distance(line.start, line.end); };
+            case position_algorithm::uniform:
+                positions = generate_uniform_positions(position_seed, args.position_gen.uniform.count);
                 break;
             default:
                 BOOST_ASSERT(false);
                 break;
         }
 
-        switch (args.edge_gen.algorithm) {
-            case edge_algorithm::planar:
-                generate_planar_edges(edge_seed, args.edge_gen.planar.probability, edge_cost_fn, graph, positions);
-                break;
-            case edge_algorithm::uniform:
-                generate_uniform_edges(edge_seed, args.edge_gen.uniform.probability, edge_cost_fn, graph, positions);
-                break;
-            case edge_algorithm::layered:
-                generate_layered_edges(edge_seed,
-                                       args.edge_gen.layered.probability,
-                                       args.edge_gen.layered.count,
-                                       edge_cost_fn,
-                                       graph,
-                                       positions);
-                break;
-            case edge_algorithm::kronecker:
-                generate_kronecker_graph(edge_seed,
-                                         args.edge_gen.kronecker.initiator,
-                                         args.edge_gen.kronecker.k,
-                                         edge_cost_fn,
-                                         graph,
-                                         positions);
-                break;
-            default:
-                BOOST_ASSERT(false);
-                break;
+        if (!check_node_count<Node, Cost>(args, positions.size(), err)) {
+            return false;
         }
+        builder.add_nodes(positions.size());
     } else {
-        std::ifstream in(args.graph_file);
-        std::string line;
-        std::vector<std::string> columns;
-        std::set<std::tuple<std::string, std::string, double>> edges;
-        std::unordered_map<std::string, size_t> nodes;
-        size_t node_index = 0;
-        while (std::getline(in, line)) {
-            trim(line);
-            if (line.empty() || starts_with(line, "#") || starts_with(line, "//") || starts_with(line, "--")) {
-                continue;
-            }
+        size_t node_count = 1;
+        for (int i = 0; i < args.edge_gen.kronecker.k; ++i) {
+            node_count *= static_cast<size_t>(std::round(std::sqrt(args.edge_gen.kronecker.initiator.size())));
+        }
+        if (!check_node_count<Node, Cost>(args, node_count, err)) {
+            return false;
+        }
+    }
 
-            columns.clear();
-            split(columns, line, [](char c) { return std::isspace(static_cast<int>(c)); }, token_compress_on);
-            if (columns.size() < 2) {
-                if (err) {
-                    (*err) << "Parse error in " << args.graph_file << "!\n";
-                }
-                return;
-            }
+    edge_cost_fn edge_cost_fn;
+    switch (args.cost_gen.algorithm) {
+        case cost_algorithm::uniform:
+            edge_cost_fn = [rng = std::mt19937(cost_seed)](const line& line) mutable {
+                return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            };
+            break;
+        case cost_algorithm::one:
+            edge_cost_fn = [](const line& line) { return 1.0; };
+            break;
+        case cost_algorithm::euclidean:
+            edge_cost_fn = [](const line& line) { return distance(line.start, line.end); };
+            break;
+        default:
+            BOOST_ASSERT(false);
+            break;
+    }
 
-            double cost = 1.0;
-            if (columns.size() >= 3) {
-                try {
-                    cost = boost::lexical_cast<double>(columns[2]);
-                } catch (const boost::bad_lexical_cast& ex) {
-                    if (err) {
-                        (*err) << "Parse error in " << args.graph_file << ": " << ex.what() << "\n";
-                    }
-                    return;
-                }
-            }
+    switch (args.edge_gen.algorithm) {
+        case edge_algorithm::planar:
+            generate_planar_edges(edge_seed, args.edge_gen.planar.probability, edge_cost_fn, builder, positions);
+            break;
+        case edge_algorithm::uniform:
+            generate_uniform_edges(edge_seed, args.edge_gen.uniform.probability, edge_cost_fn, builder, positions);
+            break;
+        case edge_algorithm::layered:
+            generate_layered_edges(edge_seed,
+                                   args.edge_gen.layered.probability,
+                                   args.edge_gen.layered.count,
+                                   edge_cost_fn,
+                                   builder,
+                                   positions);
+            break;
+        case edge_algorithm::kronecker:
+            generate_kronecker_graph(edge_seed,
+                                     args.edge_gen.kronecker.initiator,
+                                     args.edge_gen.kronecker.k,
+                                     edge_cost_fn,
+                                     builder,
+                                     positions);
+            break;
+        default:
+            BOOST_ASSERT(false);
+            break;
+    }
+    return true;
+}
+
+template <typename Node, typename Cost> void run(const arguments& args, std::ostream* out, std::ostream* err) {
+    size_t start_node = 0;
+    node_map<vec2> positions;
+    basic_graph_builder<Node, Cost> builder;
+    basic_graph<Node, Cost> graph;
+    // Without reordering and caching the graph can be built compressed right away, otherwise it is
+    // compressed after these steps.
+    bool build_compressed = args.types.compressed && args.order.algorithm == order_algorithm::none;
 
-            edges.emplace(columns[0], columns[1], cost);
-            if (nodes.find(columns[0]) == nodes.end()) {
-                nodes[columns[0]] = node_index;
-                node_index += 1;
-                graph.add_node();
+    if (args.graph_file.empty()) {
+        boost::optional<basic_graph<Node, Cost>> cached;
+        if (!args.graph_cache.empty()) {
+            cached = read_cached_graph<Node, Cost>(args, &positions);
+        }
+        if (cached) {
+            graph = *cached;
+        } else {
+            if (!generate_graph(args, builder, positions, err)) {
+                return;
             }
-            if (nodes.find(columns[1]) == nodes.end()) {
-                nodes[columns[1]] = node_index;
-                node_index += 1;
-                graph.add_node();
+            graph = build_compressed && args.graph_cache.empty() ? builder.build_compressed() : builder.build();
+            if (!args.graph_cache.empty()) {
+                write_cached_graph(args, graph, positions, err);
             }
         }
-        if (!in.eof()) {
-            if (err) {
-                (*err) << "Read error: " << args.graph_file << "\n";
-            }
+    } else if (args.graph_file_format == graph_format::binary ||
+               (args.graph_file_format == graph_format::guess && is_binary_graph_file(args.graph_file))) {
+        boost::optional<basic_graph<Node, Cost>> loaded =
+            read_binary_graph<Node, Cost>(args.graph_file, &positions, err);
+        if (!loaded) {
             return;
         }
-
-        if (graph.node_count() == 0) {
-            return; // nothing to do ...
+        graph = *loaded;
+    } else {
+        if (!read_text_graph(args.graph_file, args.graph_file_format, builder, err, args.threads)) {
+            return;
         }
-
-        for (const auto& edge : edges) {
-            graph.add_edge(nodes[std::get<0>(edge)], nodes[std::get<1>(edge)], std::get<double>(edge));
+        if (builder.node_count() == 0) {
+            return; // nothing to do ...
         }
-        positions = graph.make_node_map([](size_t) { return vec2(0.0, 0.0); });
+        positions = node_map<vec2>(builder.node_count(), vec2(0.0, 0.0));
+        graph = build_compressed ? builder.build_compressed() : builder.build();
     }
 
     if (graph.node_count() == 0) {
@@ -168,65 +275,115 @@ void sssp::execute_run(const arguments& args, std::ostream* out, std::ostream* e
         return;
     }
 
-    boost::base_collection<criteria> criteria;
-    for (sssp_algorithm crit : args.algorithms) {
-        switch (crit) {
-            case sssp_algorithm::crauser_in:
-                criteria.insert(crauser_in(&graph, start_node, false));
-                break;
-            case sssp_algorithm::crauser_in_dyn:
-                criteria.insert(crauser_in(&graph, start_node, true));
-                break;
-            case sssp_algorithm::crauser_out:
-                criteria.insert(crauser_out(&graph, start_node, false));
-                break;
-            case sssp_algorithm::crauser_out_dyn:
-                criteria.insert(crauser_out(&graph, start_node, true));
-                break;
-            case sssp_algorithm::dijkstra:
-                criteria.insert(smallest_tentative_distance(&graph, start_node));
-                break;
-            case sssp_algorithm::heuristic:
-                criteria.insert(heuristic(
-                    &graph, start_node, [&](size_t node) { return distance(positions[start_node], positions[node]); }));
-                break;
-            case sssp_algorithm::oracle:
-                criteria.insert(oracle(&graph, start_node));
-                break;
-            case sssp_algorithm::traff:
-                criteria.insert(traff_bridge(&graph, start_node));
-                break;
-            case sssp_algorithm::paper_in:
-                criteria.insert(paper_in(&graph, start_node));
-                break;
-            case sssp_algorithm::paper_out:
-                criteria.insert(paper_out(&graph, start_node));
-                break;
-            default:
-                BOOST_ASSERT(false);
-                break;
+    // The algorithms run on the reordered graph, the results are mapped back to the original
+    // node indices afterwards. Thus, the output does not depend on the order.
+    node_order order;
+    switch (args.order.algorithm) {
+        case order_algorithm::none:
+            break;
+        case order_algorithm::hilbert:
+            order = hilbert_order(positions);
+            break;
+        case order_algorithm::bfs:
+            order = bfs_order(graph, start_node);
+            break;
+        case order_algorithm::rcm:
+            order = rcm_order(graph);
+            break;
+        default:
+            BOOST_ASSERT(false);
+            break;
+    }
+    basic_graph<Node, Cost> ordered_graph;
+    node_map<vec2> ordered_positions;
+    size_t run_start_node = start_node;
+    if (!order.empty()) {
+        ordered_graph = reorder_graph(graph, order);
+        ordered_positions = reorder_node_map(positions, order);
+        run_start_node = inverse_order(order)[start_node];
+    }
+    if (args.types.compressed) {
+        basic_graph<Node, Cost>& uncompressed = order.empty() ? graph : ordered_graph;
+        if (!uncompressed.is_compressed()) {
+            uncompressed = compress_graph(uncompressed);
         }
     }
+    const basic_graph<Node, Cost>& run_graph = order.empty() ? graph : ordered_graph;
+    const node_map<vec2>& run_positions = order.empty() ? positions : ordered_positions;
 
-    node_map<dijkstra_result> result = dijkstra(graph, start_node, criteria);
+    node_map<basic_dijkstra_result<Node, Cost>> result;
+    // Only set by the label correcting algorithms, which may relax a node in multiple phases.
+    std::vector<label_correcting_phase> label_correcting_phases;
+    // The phases depend on the delta, so the CSV reports the one delta_stepping() used instead of the
+    // requested one, which may be chosen automatically or raised.
+    arguments csv_args = args;
+    if (args.algorithms[0] == sssp_algorithm::delta_stepping) {
+        Cost delta = args.delta > 0 ? static_cast<Cost>(args.delta) : default_delta(run_graph);
+        basic_label_correcting_result<Node, Cost> delta_result = delta_stepping(run_graph, run_start_node, delta);
+        csv_args.delta = static_cast<double>(delta_result.delta);
+        result = std::move(delta_result.nodes);
+        label_correcting_phases = std::move(delta_result.phases);
+    } else if (args.algorithms[0] == sssp_algorithm::radius_stepping) {
+        node_map<Cost> radii = ball_radii(run_graph, args.rho, args.threads);
+        basic_label_correcting_result<Node, Cost> radius_result = radius_stepping(run_graph, run_start_node, radii);
+        result = std::move(radius_result.nodes);
+        label_correcting_phases = std::move(radius_result.phases);
+    } else if (!run_static_dijkstra(args, run_graph, run_start_node, run_positions, result, err)) {
+        boost::base_collection<basic_criteria<Node, Cost>> criteria;
+        for (sssp_algorithm algorithm : args.algorithms) {
+            with_criteria(args, algorithm, run_graph, run_start_node, run_positions, [&](auto&& crit) {
+                criteria.insert(std::move(crit));
+            });
+        }
+        result = dijkstra(run_graph, run_start_node, criteria, args.threads);
+        if (err) {
+            for (const auto& crit : criteria) {
+                crit.print_counters(*err);
+            }
+        }
+    }
+    if (!order.empty()) {
+        node_map<basic_dijkstra_result<Node, Cost>> ordered_result = std::move(result);
+        result.resize(ordered_result.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            result[order[i]] = ordered_result[i];
+            if (ordered_result[i].predecessor != Node(-1)) {
+                result[order[i]].predecessor = static_cast<Node>(order[ordered_result[i].predecessor]);
+            }
+        }
+    }
 
     size_t reachable = 0;
     int max_phase = 0;
     std::vector<size_t> relaxed(graph.node_count(), 0);
     std::vector<size_t> fringe_size(graph.node_count(), 0);
-    for (const auto& r : result) {
-        if (r.settled()) {
-            reachable += 1;
-            max_phase = std::max(max_phase, r.relaxation_phase);
-            relaxed[r.relaxation_phase] += 1;
-            fringe_size[r.relaxation_phase] = std::max(fringe_size[r.relaxation_phase], r.fringe_size);
+    std::vector<size_t> rerelaxed(graph.node_count(), 0);
+    if (label_correcting_phases.empty()) {
+        for (const auto& r : result) {
+            if (r.settled()) {
+                reachable += 1;
+                max_phase = std::max(max_phase, r.relaxation_phase);
+                relaxed[r.relaxation_phase] += 1;
+                fringe_size[r.relaxation_phase] = std::max(fringe_size[r.relaxation_phase], r.fringe_size);
+            }
+        }
+    } else {
+        max_phase = static_cast<int>(label_correcting_phases.size()) - 1;
+        relaxed.resize(label_correcting_phases.size());
+        fringe_size.resize(label_correcting_phases.size());
+        rerelaxed.resize(label_correcting_phases.size());
+        for (size_t phase = 0; phase < label_correcting_phases.size(); ++phase) {
+            relaxed[phase] = label_correcting_phases[phase].relaxed;
+            fringe_size[phase] = label_correcting_phases[phase].fringe_size;
+            rerelaxed[phase] = label_correcting_phases[phase].rerelaxed;
         }
     }
 
     if (out) {
+        const std::string csv_values = arguments_csv_values(csv_args);
         for (int phase = 0; phase <= max_phase; ++phase) {
-            *out << arguments_csv_values(args) << "," << graph.node_count() << "," << phase << "," << relaxed[phase]
-                 << "," << fringe_size[phase] << "\n";
+            *out << csv_values << "," << graph.node_count() << "," << phase << "," << relaxed[phase] << ","
+                 << fringe_size[phase] << "," << rerelaxed[phase] << "\n";
         }
     }
 
@@ -273,17 +430,11 @@ void sssp::execute_run(const arguments& args, std::ostream* out, std::ostream* e
             return style;
         });
 
-        edge_map<edge_style> edge_styles = graph.make_edge_map([&](size_t source, size_t destination) {
+        edge_map<edge_style> edge_styles = graph.make_edge_map([&](const basic_edge_info<Node, Cost>& edge) {
             edge_style style;
+            style.text = std::to_string(int(std::round(edge.cost * 1000))) + ">";
 
-            for (const edge_info& edge : graph.outgoing_edges(source)) {
-                if (edge.destination == destination) {
-                    style.text = std::to_string(int(std::round(edge.cost * 1000))) + ">";
-                    break;
-                }
-            }
-
-            if (result[destination].predecessor == source) {
+            if (result[edge.destination].predecessor == edge.source) {
                 style.line_width *= 2;
                 style.color = rgb(0.25, 0.25, 1.0);
                 style.foreground = true;
@@ -322,3 +473,17 @@ void sssp::execute_run(const arguments& args, std::ostream* out, std::ostream* e
     }
 #endif
 }
+
+} // namespace
+
+void sssp::execute_run(const arguments& args, std::ostream* out, std::ostream* err) {
+    if (args.types.node == node_index_type::uint32 && args.types.cost == edge_cost_type::float32) {
+        run<uint32_t, float>(args, out, err);
+    } else if (args.types.node == node_index_type::uint32) {
+        run<uint32_t, double>(args, out, err);
+    } else if (args.types.cost == edge_cost_type::float32) {
+        run<size_t, float>(args, out, err);
+    } else {
+        run<size_t, double>(args, out, err);
+    }
+}
@@ -5,6 +5,7 @@
 #include "crit_traff_bridge.hpp"
 #include "crit_paper_in.hpp"
 #include "crit_paper_out.hpp"
+#include "dijkstra_engine.hpp"
 #include "graph.hpp"
 #include "test_graph.hpp"
 #include <boost/mpl/list.hpp>
@@ -12,6 +13,7 @@
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 #include <cfloat>
+#include <random>
 
 using namespace sssp;
 
@@ -33,6 +35,117 @@ struct crauser_out_dynamic : crauser_out {
     crauser_out_dynamic(const sssp::graph* g, size_t s) : crauser_out(g, s, true) {}
 };
 
+// The variants with lazy threshold queues and the criteria they have to match.
+struct crauser_in_lazy : lazy_crauser_in {
+    using eager = crauser_in_dynamic;
+    crauser_in_lazy(const sssp::graph* g, size_t s) : lazy_crauser_in(g, s, true) {}
+};
+
+struct crauser_out_lazy : lazy_crauser_out {
+    using eager = crauser_out_dynamic;
+    crauser_out_lazy(const sssp::graph* g, size_t s) : lazy_crauser_out(g, s, true) {}
+};
+
+struct traff_bridge_lazy : lazy_traff_bridge {
+    using eager = traff_bridge;
+    using lazy_traff_bridge::lazy_traff_bridge;
+};
+
+// Receives the single notifications even if the criteria supports batches.
+template <typename Criteria> struct per_event : Criteria {
+    using Criteria::Criteria;
+    bool batches_notifications() const override { return false; }
+};
+
+// The paper criteria as they were before they kept their thresholds up to date: Each phase scans
+// all nodes and their edges. The incremental criteria have to relax the same nodes in each phase.
+class full_scan_criteria : public criteria {
+  public:
+    full_scan_criteria(const sssp::graph* g, size_t s) : criteria(g, s), m_node_info(g->node_count()) {}
+    void changed_predecessor(size_t node, size_t predecessor, double distance) override {
+        BOOST_REQUIRE(!m_node_info[node].settled);
+        m_node_info[node].tentative_distance = distance;
+    }
+    void relaxed_node(size_t node) override {
+        BOOST_REQUIRE(!m_node_info[node].settled);
+        m_node_info[node].settled = true;
+    }
+    bool is_complete() const override { return true; }
+
+  protected:
+    bool settled(size_t node) const { return m_node_info[node].settled; }
+    bool unexplored(size_t node) const { return !settled(node) && tentative(node) == INFINITY; }
+    double tentative(size_t node) const { return m_node_info[node].tentative_distance; }
+
+  private:
+    struct node_info {
+        bool settled = false;
+        double tentative_distance = INFINITY;
+    };
+
+    node_map<node_info> m_node_info;
+};
+
+struct paper_in_full_scan : full_scan_criteria {
+    using full_scan_criteria::full_scan_criteria;
+    void relaxable_nodes(todo_output& output) const override {
+        double min_tent = INFINITY;
+        for (size_t node = 0; node < graph().node_count(); ++node) {
+            if (!settled(node)) {
+                min_tent = std::min(min_tent, tentative(node));
+            }
+        }
+        for (size_t node = 0; node < graph().node_count(); ++node) {
+            if (settled(node) || unexplored(node)) {
+                continue;
+            }
+            double min_incoming = INFINITY;
+            for (const edge_info& edge : graph().incoming_edges(node)) {
+                if (settled(edge.source)) {
+                    // predecessor in S
+                } else if (unexplored(edge.source)) {
+                    min_incoming = std::min(min_incoming, edge.cost + graph().index().min_incoming_cost(edge.source));
+                } else {
+                    min_incoming = std::min(min_incoming, edge.cost);
+                }
+            }
+            if (tentative(node) - min_incoming <= min_tent) {
+                output.emplace(node);
+            }
+        }
+    }
+};
+
+struct paper_out_full_scan : full_scan_criteria {
+    using full_scan_criteria::full_scan_criteria;
+    void relaxable_nodes(todo_output& output) const override {
+        double min_threshold = INFINITY;
+        for (size_t node = 0; node < graph().node_count(); ++node) {
+            if (settled(node) || unexplored(node)) {
+                continue;
+            }
+            for (const edge_info& edge : graph().outgoing_edges(node)) {
+                if (settled(edge.destination)) {
+                    // successor in S
+                } else if (unexplored(edge.destination)) {
+                    for (const edge_info& next_edge : graph().outgoing_edges(edge.destination)) {
+                        if (!settled(next_edge.destination)) {
+                            min_threshold = std::min(min_threshold, tentative(node) + edge.cost + next_edge.cost);
+                        }
+                    }
+                } else {
+                    min_threshold = std::min(min_threshold, tentative(node) + edge.cost);
+                }
+            }
+        }
+        for (size_t node = 0; node < graph().node_count(); ++node) {
+            if (!settled(node) && !unexplored(node) && tentative(node) <= min_threshold) {
+                output.emplace(node);
+            }
+        }
+    }
+};
+
 } // namespace
 
 using non_euclidean_tests = boost::mpl::list<paper_out,
@@ -79,23 +192,170 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(criteria_non_euclidean_test, Criteria, non_euclide
     }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(criteria_parallel_relaxation_test, Criteria, non_euclidean_tests) {
+    for (int seed = 0; seed < test_count / 10; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            auto run = [&](size_t thread_count) {
+                boost::base_collection<criteria> cs;
+                cs.insert(Criteria(&g, 0));
+                cs.insert(smallest_tentative_distance(&g, 0));
+                return dijkstra(g, 0, cs, thread_count);
+            };
+            node_map<dijkstra_result> reference = run(1);
+            node_map<dijkstra_result> result = run(3);
+
+            for (size_t node = 0; node < g.node_count(); ++node) {
+                BOOST_TEST_CONTEXT("node = " << node) {
+                    BOOST_REQUIRE(reference[node].predecessor == result[node].predecessor);
+                    BOOST_REQUIRE(reference[node].distance == result[node].distance);
+                    BOOST_REQUIRE(reference[node].relaxation_phase == result[node].relaxation_phase);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(criteria_parallel_evaluation_test) {
+    // Large enough for fringes in which the criteria are asked in parallel and for phases with
+    // enough edges to be relaxed in parallel.
+    std::mt19937 rng(7);
+    const size_t node_count = 20000;
+    graph_builder b;
+    b.add_nodes(node_count);
+    for (size_t node = 0; node < node_count; ++node) {
+        for (int i = 0; i < 32; ++i) {
+            b.add_edge(node,
+                       std::uniform_int_distribution<size_t>(0, node_count - 1)(rng),
+                       std::uniform_real_distribution<double>(0, 1)(rng));
+        }
+    }
+    const graph g = b.build();
+
+    auto run_dynamic = [&](size_t thread_count) {
+        boost::base_collection<criteria> cs;
+        cs.insert(crauser_in_static(&g, 0));
+        cs.insert(crauser_out_dynamic(&g, 0));
+        cs.insert(traff_bridge(&g, 0));
+        cs.insert(paper_in(&g, 0));
+        return dijkstra(g, 0, cs, thread_count);
+    };
+    auto run_static = [&](size_t thread_count) {
+        auto cs = std::make_tuple(
+            crauser_in_static(&g, 0), crauser_out_dynamic(&g, 0), traff_bridge(&g, 0), paper_in(&g, 0));
+        return dijkstra(g, 0, cs, thread_count);
+    };
+    node_map<dijkstra_result> reference = run_dynamic(1);
+    for (const auto& result : {run_dynamic(4), run_static(1), run_static(4)}) {
+        for (size_t node = 0; node < g.node_count(); ++node) {
+            BOOST_TEST_CONTEXT("node = " << node) {
+                BOOST_REQUIRE(reference[node].predecessor == result[node].predecessor);
+                BOOST_REQUIRE(reference[node].distance == result[node].distance);
+                BOOST_REQUIRE(reference[node].relaxation_phase == result[node].relaxation_phase);
+            }
+        }
+    }
+}
+
+using batching_tests = boost::mpl::list<paper_out,
+                                        paper_in,
+                                        traff_bridge,
+                                        crauser_out_static,
+                                        crauser_out_dynamic,
+                                        crauser_in_static,
+                                        crauser_in_dynamic>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(criteria_batched_notifications_test, Criteria, batching_tests) {
+    for (int seed = 0; seed < test_count / 10; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            Criteria batching(&g, 0);
+            BOOST_REQUIRE(batching.batches_notifications());
+            boost::base_collection<criteria> cs;
+            cs.insert(batching);
+            cs.insert(smallest_tentative_distance(&g, 0));
+            node_map<dijkstra_result> result = dijkstra(g, 0, cs);
+
+            cs.clear();
+            cs.insert(per_event<Criteria>(&g, 0));
+            cs.insert(smallest_tentative_distance(&g, 0));
+            node_map<dijkstra_result> reference = dijkstra(g, 0, cs);
+
+            for (size_t node = 0; node < g.node_count(); ++node) {
+                BOOST_TEST_CONTEXT("node = " << node) {
+                    BOOST_REQUIRE(reference[node].predecessor == result[node].predecessor);
+                    BOOST_REQUIRE(reference[node].distance == result[node].distance);
+                    BOOST_REQUIRE(reference[node].relaxation_phase == result[node].relaxation_phase);
+                }
+            }
+        }
+    }
+}
+
+using lazy_queue_tests = boost::mpl::list<crauser_in_lazy, crauser_out_lazy, traff_bridge_lazy>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(criteria_lazy_queue_test, Criteria, lazy_queue_tests) {
+    for (int seed = 0; seed < test_count / 10; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            auto lazy = std::make_tuple(Criteria(&g, 0), smallest_tentative_distance(&g, 0));
+            node_map<dijkstra_result> result = dijkstra(g, 0, lazy);
+            auto eager = std::make_tuple(typename Criteria::eager(&g, 0), smallest_tentative_distance(&g, 0));
+            node_map<dijkstra_result> reference = dijkstra(g, 0, eager);
+
+            for (size_t node = 0; node < g.node_count(); ++node) {
+                BOOST_TEST_CONTEXT("node = " << node) {
+                    BOOST_REQUIRE(reference[node].predecessor == result[node].predecessor);
+                    BOOST_REQUIRE(reference[node].distance == result[node].distance);
+                    BOOST_REQUIRE(reference[node].relaxation_phase == result[node].relaxation_phase);
+                }
+            }
+        }
+    }
+}
+
+// The incremental criteria and their full scan references.
+using full_scan_tests =
+    boost::mpl::list<std::pair<paper_in, paper_in_full_scan>, std::pair<paper_out, paper_out_full_scan>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(criteria_full_scan_test, Criteria, full_scan_tests) {
+    for (int seed = 0; seed < test_count; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            auto incremental = std::make_tuple(typename Criteria::first_type(&g, 0));
+            node_map<dijkstra_result> result = dijkstra(g, 0, incremental);
+            auto full_scan = std::make_tuple(typename Criteria::second_type(&g, 0));
+            node_map<dijkstra_result> reference = dijkstra(g, 0, full_scan);
+
+            for (size_t node = 0; node < g.node_count(); ++node) {
+                BOOST_TEST_CONTEXT("node = " << node) {
+                    BOOST_REQUIRE(reference[node].predecessor == result[node].predecessor);
+                    BOOST_REQUIRE(reference[node].distance == result[node].distance);
+                    BOOST_REQUIRE(reference[node].relaxation_phase == result[node].relaxation_phase);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(traffs_counter_example, Criteria, non_euclidean_tests) {
     //          5 --8--> 4 --3
     //                       |  /-- 1 --> 6
     //                       v /
     // 1 <--100-- 0 --110--> 2 <--\
     //            \--105--> 3 --2-/
-    graph g;
+    graph_builder b;
     for (size_t i = 0; i <= 6; ++i) {
-        g.add_node();
+        b.add_node();
     }
-    g.add_edge(0, 1, 100);
-    g.add_edge(0, 2, 110);
-    g.add_edge(0, 3, 105);
-    g.add_edge(2, 6, 1);
-    g.add_edge(3, 2, 2);
-    g.add_edge(4, 2, 3);
-    g.add_edge(5, 4, 8);
+    b.add_edge(0, 1, 100);
+    b.add_edge(0, 2, 110);
+    b.add_edge(0, 3, 105);
+    b.add_edge(2, 6, 1);
+    b.add_edge(3, 2, 2);
+    b.add_edge(4, 2, 3);
+    b.add_edge(5, 4, 8);
+    const graph g = b.build();
 
     boost::base_collection<criteria> cs;
     cs.insert(Criteria(&g, 0));
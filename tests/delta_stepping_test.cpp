@@ -0,0 +1,83 @@
+#include "delta_stepping.hpp"
+#include "graph.hpp"
+#include "test_graph.hpp"
+#include <boost/test/unit_test.hpp>
+#include <cfloat>
+#include <numeric>
+
+using namespace sssp;
+
+namespace {
+
+size_t total_rerelaxed(const label_correcting_result& result) {
+    return std::accumulate(result.phases.begin(),
+                           result.phases.end(),
+                           size_t(0),
+                           [](size_t sum, const label_correcting_phase& phase) { return sum + phase.rerelaxed; });
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(delta_stepping_distances_test) {
+    for (int seed = 0; seed < 100; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            for (double delta : {default_delta(g), 0.001, 1e-12, 1e-300, 1e9}) {
+                BOOST_TEST_CONTEXT("delta = " << delta) {
+                    check_label_correcting_distances(g, delta_stepping(g, 0, delta));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(delta_stepping_rerelaxation_test) {
+    const graph g = make_detour_graph();
+
+    // All edges are light, 1 is relaxed with 0.5 first and again with 0.2.
+    label_correcting_result one_bucket = delta_stepping(g, 0, 1.0);
+    BOOST_TEST(one_bucket.delta == 1.0);
+    BOOST_TEST_REQUIRE(one_bucket.phases.size() == 3);
+    BOOST_TEST(one_bucket.phases[0].relaxed == 1);
+    BOOST_TEST(one_bucket.phases[1].relaxed == 2);
+    BOOST_TEST(one_bucket.phases[1].fringe_size == 2);
+    BOOST_TEST(one_bucket.phases[2].relaxed == 1);
+    BOOST_TEST(one_bucket.phases[2].rerelaxed == 1);
+    BOOST_TEST(one_bucket.nodes[1].predecessor == 2);
+    BOOST_TEST(one_bucket.nodes[1].relaxation_phase == 2);
+
+    // All edges are heavy, every bucket takes a light phase and maybe a heavy phase.
+    label_correcting_result heavy = delta_stepping(g, 0, 0.05);
+    BOOST_TEST(heavy.phases.size() == 5);
+    BOOST_TEST(total_rerelaxed(heavy) == 0);
+    BOOST_TEST(heavy.nodes[1].predecessor == 2);
+    BOOST_TEST(heavy.nodes[1].distance == 0.2, boost::test_tools::tolerance(DBL_EPSILON));
+}
+
+BOOST_AUTO_TEST_CASE(delta_stepping_tiny_delta_test) {
+    // Far more buckets than nodes, most of them are skipped. The phases are the same as with any
+    // delta below the smallest edge cost.
+    const graph g = make_detour_graph();
+    for (double delta : {1e-12, 1e-300}) {
+        BOOST_TEST_CONTEXT("delta = " << delta) {
+            label_correcting_result result = delta_stepping(g, 0, delta);
+            // Only the delta too small to number the buckets is raised.
+            BOOST_TEST((result.delta == delta) == (delta == 1e-12));
+            BOOST_TEST(result.delta >= delta);
+            BOOST_TEST(result.phases.size() == 5);
+            BOOST_TEST(total_rerelaxed(result) == 0);
+            BOOST_TEST(result.nodes[1].predecessor == 2);
+            BOOST_TEST(result.nodes[1].distance == 0.2, boost::test_tools::tolerance(DBL_EPSILON));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(default_delta_test) {
+    // Maximal cost 0.5 and one edge per node.
+    BOOST_TEST(default_delta(make_detour_graph()) == 0.5);
+
+    graph_builder b;
+    b.add_nodes(2);
+    b.add_edge(0, 1, 0.0);
+    BOOST_TEST(default_delta(b.build()) == 1.0);
+}
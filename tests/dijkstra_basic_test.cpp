@@ -1,6 +1,9 @@
 #include "crit_dijkstra.hpp"
 #include "dijkstra.hpp"
+#include "dijkstra_engine.hpp"
 #include "graph.hpp"
+#include "test_graph.hpp"
+#include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 #include <cfloat>
 
@@ -8,14 +11,15 @@ using namespace sssp;
 namespace tt = boost::test_tools;
 
 BOOST_AUTO_TEST_CASE(dijkstra_basic_test_1) {
-    graph g;
+    graph_builder b;
     for (size_t i = 0; i < 4; ++i) {
-        g.add_node();
+        b.add_node();
     }
-    g.add_edge(0, 1, 1.0);
-    g.add_edge(0, 2, 0.3);
-    g.add_edge(2, 3, 0.3);
-    g.add_edge(3, 1, 0.3);
+    b.add_edge(0, 1, 1.0);
+    b.add_edge(0, 2, 0.3);
+    b.add_edge(2, 3, 0.3);
+    b.add_edge(3, 1, 0.3);
+    const graph g = b.build();
 
     boost::base_collection<criteria> criteria;
     criteria.insert(smallest_tentative_distance(&g, 0));
@@ -33,17 +37,18 @@ BOOST_AUTO_TEST_CASE(dijkstra_basic_test_1) {
 }
 
 BOOST_AUTO_TEST_CASE(dijkstra_basic_test_2) {
-    graph g;
+    graph_builder b;
     for (size_t i = 0; i < 10; ++i) {
-        g.add_node();
+        b.add_node();
     }
     for (size_t i = 0; i < 10; ++i) {
         for (size_t j = 0; j < 10; ++j) {
             if (i != j) {
-                g.add_edge(i, j, 1.0);
+                b.add_edge(i, j, 1.0);
             }
         }
     }
+    const graph g = b.build();
 
     boost::base_collection<criteria> criteria;
     criteria.insert(smallest_tentative_distance(&g, 0));
@@ -59,14 +64,15 @@ BOOST_AUTO_TEST_CASE(dijkstra_basic_test_2) {
 }
 
 BOOST_AUTO_TEST_CASE(dijkstra_basic_test_3) {
-    graph g;
-    g.add_node();
-    g.add_node();
-    g.add_node();
-    g.add_edge(0, 1, 1.0);
-    g.add_edge(1, 0, 1.0);
-    g.add_edge(2, 1, 1.0);
-    g.add_edge(2, 0, 1.0);
+    graph_builder b;
+    b.add_node();
+    b.add_node();
+    b.add_node();
+    b.add_edge(0, 1, 1.0);
+    b.add_edge(1, 0, 1.0);
+    b.add_edge(2, 1, 1.0);
+    b.add_edge(2, 0, 1.0);
+    const graph g = b.build();
 
     boost::base_collection<criteria> criteria;
     criteria.insert(smallest_tentative_distance(&g, 0));
@@ -80,3 +86,67 @@ BOOST_AUTO_TEST_CASE(dijkstra_basic_test_3) {
     BOOST_TEST(result[1].distance == 1.0, tt::tolerance(DBL_EPSILON));
     BOOST_TEST(result[2].distance == INFINITY);
 }
+
+using graph_types = boost::mpl::list<basic_graph<size_t, double>,
+                                     basic_graph<size_t, float>,
+                                     basic_graph<uint32_t, double>,
+                                     basic_graph<uint32_t, float>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra_basic_types_test, Graph, graph_types) {
+    using Node = typename Graph::node_type;
+    using Cost = typename Graph::cost_type;
+
+    basic_graph_builder<Node, Cost> b;
+    b.add_nodes(4);
+    b.add_edge(0, 1, 1.0f);
+    b.add_edge(0, 2, 0.25f);
+    b.add_edge(2, 3, 0.25f);
+    b.add_edge(3, 1, 0.25f);
+    const Graph g = b.build();
+
+    boost::base_collection<basic_criteria<Node, Cost>> criteria;
+    criteria.insert(basic_smallest_tentative_distance<Node, Cost>(&g, 0));
+    node_map<basic_dijkstra_result<Node, Cost>> result = dijkstra(g, 0, criteria);
+
+    BOOST_TEST_REQUIRE(result.size() == 4);
+    BOOST_TEST(result[0].predecessor == Node(-1));
+    BOOST_TEST(result[1].predecessor == 3);
+    BOOST_TEST(result[2].predecessor == 0);
+    BOOST_TEST(result[3].predecessor == 2);
+    BOOST_TEST(result[1].distance == Cost(0.75));
+    BOOST_TEST(result[1].relaxation_phase == 3);
+}
+
+BOOST_AUTO_TEST_CASE(dijkstra_static_criteria_test) {
+    for (int seed = 0; seed < 10; ++seed) {
+        const graph g = make_test_graph(seed);
+
+        boost::base_collection<criteria> cs;
+        cs.insert(smallest_tentative_distance(&g, 0));
+        node_map<dijkstra_result> reference = dijkstra(g, 0, cs);
+
+        auto static_cs = std::make_tuple(smallest_tentative_distance(&g, 0));
+        node_map<dijkstra_result> result = dijkstra(g, 0, static_cs);
+
+        BOOST_TEST_REQUIRE(result.size() == reference.size());
+        for (size_t node = 0; node < g.node_count(); ++node) {
+            BOOST_TEST(result[node].predecessor == reference[node].predecessor);
+            BOOST_TEST(result[node].distance == reference[node].distance);
+            BOOST_TEST(result[node].relaxation_phase == reference[node].relaxation_phase);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dijkstra_reference_distances_test) {
+    for (int seed = 0; seed < 10; ++seed) {
+        const graph g = make_test_graph(seed);
+        const node_map<double>& distances = g.reference_distances(0);
+        BOOST_TEST(distances == shortest_distances(g, 0));
+
+        // The distances are computed once per start node and shared with copies.
+        const graph copy = g;
+        BOOST_TEST(&copy.reference_distances(0) == &distances);
+        BOOST_TEST(&g.reference_distances(1) != &distances);
+        BOOST_TEST(g.reference_distances(1) == shortest_distances(g, 1));
+    }
+}
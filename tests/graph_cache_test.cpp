@@ -0,0 +1,101 @@
+#include "graph_cache.hpp"
+#include "test_graph.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fstream>
+
+using namespace sssp;
+
+BOOST_AUTO_TEST_CASE(graph_cache_key_test) {
+    arguments args;
+    const std::string key = graph_cache_key(args);
+    BOOST_TEST(key == graph_cache_key(args));
+
+    // Arguments of algorithms that are not used do not change the key.
+    arguments other = args;
+    other.position_gen.uniform.count = 100;
+    other.edge_gen.layered.count = 5;
+    other.order.algorithm = order_algorithm::rcm;
+    other.algorithms = {sssp_algorithm::oracle};
+    BOOST_TEST(graph_cache_key(other) == key);
+
+    other = args;
+    other.seed = 43;
+    BOOST_TEST(graph_cache_key(other) != key);
+    other = args;
+    other.edge_gen.planar.probability = 0.5;
+    BOOST_TEST(graph_cache_key(other) != key);
+    other = args;
+    other.types.cost = edge_cost_type::float32;
+    BOOST_TEST(graph_cache_key(other) != key);
+
+    // Kronecker graphs have no positions.
+    arguments kronecker = args;
+    kronecker.edge_gen.algorithm = edge_algorithm::kronecker;
+    other = kronecker;
+    other.position_gen.poisson.min_distance = 0.5;
+    BOOST_TEST(graph_cache_key(other) == graph_cache_key(kronecker));
+}
+
+BOOST_AUTO_TEST_CASE(graph_cache_round_trip_test) {
+    graph expected;
+    node_map<vec2> expected_positions;
+    std::tie(expected, expected_positions) = make_test_graph_euclidean(3);
+
+    arguments args;
+    args.graph_cache =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path() / "cache").string();
+    node_map<vec2> positions;
+    bool cached = read_cached_graph<size_t, double>(args, &positions).is_initialized();
+    BOOST_TEST(!cached);
+
+    BOOST_TEST_REQUIRE(write_cached_graph(args, expected, expected_positions, nullptr));
+    boost::optional<graph> g = read_cached_graph<size_t, double>(args, &positions);
+    BOOST_TEST_REQUIRE(g.is_initialized());
+    BOOST_TEST(g->node_count() == expected.node_count());
+    BOOST_TEST(g->edge_count() == expected.edge_count());
+    for (size_t node = 0; node < expected.node_count(); ++node) {
+        BOOST_TEST_REQUIRE(g->outgoing_edges(node).size() == expected.outgoing_edges(node).size());
+        for (size_t i = 0; i < expected.outgoing_edges(node).size(); ++i) {
+            BOOST_TEST(g->outgoing_edges(node)[i].destination == expected.outgoing_edges(node)[i].destination);
+            BOOST_TEST(g->outgoing_edges(node)[i].cost == expected.outgoing_edges(node)[i].cost);
+        }
+    }
+    BOOST_TEST((positions == expected_positions));
+
+    // Only the cache file is left, no temporary files.
+    size_t file_count = std::distance(boost::filesystem::directory_iterator(args.graph_cache),
+                                      boost::filesystem::directory_iterator());
+    BOOST_TEST(file_count == 1);
+    boost::filesystem::remove_all(boost::filesystem::path(args.graph_cache).parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(graph_cache_damaged_file_test) {
+    graph expected;
+    node_map<vec2> expected_positions;
+    std::tie(expected, expected_positions) = make_test_graph_euclidean(3);
+
+    arguments args;
+    args.graph_cache =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path() / "cache").string();
+    BOOST_TEST_REQUIRE(write_cached_graph(args, expected, expected_positions, nullptr));
+
+    // Overwrite the last position with another valid one, which the binary graph format cannot notice.
+    {
+        std::fstream file(graph_cache_path(args), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-int(sizeof(uint64_t) + sizeof(double)), std::ios::end);
+        double coordinate = 12.5;
+        file.write(reinterpret_cast<const char*>(&coordinate), sizeof(coordinate));
+    }
+    node_map<vec2> positions;
+    bool cached = read_cached_graph<size_t, double>(args, &positions).is_initialized();
+    BOOST_TEST(!cached);
+
+    // The graph is generated again and replaces the damaged file.
+    BOOST_TEST_REQUIRE(write_cached_graph(args, expected, expected_positions, nullptr));
+    cached = read_cached_graph<size_t, double>(args, &positions).is_initialized();
+    BOOST_TEST(cached);
+    BOOST_TEST((positions == expected_positions));
+    boost::filesystem::remove_all(boost::filesystem::path(args.graph_cache).parent_path());
+}
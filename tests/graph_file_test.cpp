@@ -0,0 +1,227 @@
+#include "graph_file.hpp"
+#include "test_graph.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+
+using namespace sssp;
+namespace tt = boost::test_tools;
+
+// Writes the content to a new temporary file and returns its path.
+static std::string temporary_file(const std::string& content, const std::string& extension = "") {
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    path += extension;
+    std::ofstream out(path.string());
+    out << content;
+    return path.string();
+}
+
+BOOST_AUTO_TEST_CASE(read_edge_list_test) {
+    std::string path = temporary_file("# comment\n"
+                                      "a b 0.5\n"
+                                      "\n"
+                                      "  b\tc\n"
+                                      "c a 2");
+
+    graph_builder b;
+    BOOST_TEST_REQUIRE(read_edge_list(path, b, nullptr));
+    const graph g = b.build();
+    boost::filesystem::remove(path);
+
+    BOOST_TEST_REQUIRE(g.node_count() == 3);
+    BOOST_TEST_REQUIRE(g.edge_count() == 3);
+    BOOST_TEST(g.outgoing_edges(0)[0].destination == 1);
+    BOOST_TEST(g.outgoing_edges(0)[0].cost == 0.5);
+    BOOST_TEST(g.outgoing_edges(1)[0].cost == 1.0);
+    BOOST_TEST(g.outgoing_edges(2)[0].cost == 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(read_edge_list_errors_test) {
+    for (const char* content : {"a b 0.5\nc\n", "a b x\n", "a b 1.0x\n"}) {
+        std::string path = temporary_file(content);
+        graph_builder b;
+        BOOST_TEST(!read_edge_list(path, b, nullptr));
+        boost::filesystem::remove(path);
+    }
+    graph_builder b;
+    BOOST_TEST(!read_edge_list("does-not-exist", b, nullptr));
+}
+
+BOOST_AUTO_TEST_CASE(read_edge_list_large_test) {
+    // Large enough to be parsed by multiple threads. The nodes are numbered in the order of
+    // appearance, with integer names and with other names, independent of the thread count.
+    const size_t edge_count = 200000;
+    for (const char* prefix : {"", "n"}) {
+        std::ostringstream content;
+        for (size_t e = 0; e < edge_count; ++e) {
+            content << prefix << (edge_count - e) * 7 << " " << prefix << (edge_count - e) * 7 + 1 << " 1.5\n";
+        }
+        std::string path = temporary_file(content.str());
+        for (size_t threads : {1, 4}) {
+            BOOST_TEST_CONTEXT("prefix = " << prefix << ", threads = " << threads) {
+                graph_builder b;
+                BOOST_TEST_REQUIRE(read_edge_list(path, b, nullptr, threads));
+                const graph g = b.build();
+
+                BOOST_TEST_REQUIRE(g.node_count() == 2 * edge_count);
+                BOOST_TEST_REQUIRE(g.edge_count() == edge_count);
+                for (size_t node = 0; node < g.node_count(); node += 2) {
+                    BOOST_TEST_REQUIRE(g.outgoing_edges(node).size() == 1);
+                    BOOST_TEST_REQUIRE(g.outgoing_edges(node)[0].destination == node + 1);
+                }
+            }
+        }
+        boost::filesystem::remove(path);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_edge_list_leading_zeros_test) {
+    // Names with leading zeros are not integers, 01 and 1 are different nodes.
+    std::string path = temporary_file("01 2 0.5\n1 3 0.5\n");
+    graph_builder b;
+    BOOST_TEST_REQUIRE(read_edge_list(path, b, nullptr));
+    const graph g = b.build();
+    boost::filesystem::remove(path);
+
+    BOOST_TEST_REQUIRE(g.node_count() == 4);
+    BOOST_TEST(g.outgoing_edges(0)[0].destination == 1);
+    BOOST_TEST(g.outgoing_edges(2)[0].destination == 3);
+}
+
+BOOST_AUTO_TEST_CASE(read_dimacs_test) {
+    std::string path = temporary_file("c 9th DIMACS challenge\n"
+                                      "p sp 4 3\n"
+                                      "a 1 2 10\n"
+                                      "a 2 4 20\n"
+                                      "c comment\n"
+                                      "a 4 1 5\n",
+                                      ".gr");
+    BOOST_TEST((guess_graph_format(path) == graph_format::dimacs));
+    graph_builder b;
+    BOOST_TEST_REQUIRE(read_text_graph(path, graph_format::guess, b, nullptr));
+    const graph g = b.build();
+    boost::filesystem::remove(path);
+
+    BOOST_TEST_REQUIRE(g.node_count() == 4);
+    BOOST_TEST_REQUIRE(g.edge_count() == 3);
+    BOOST_TEST(g.outgoing_edges(1)[0].destination == 3);
+    BOOST_TEST(g.outgoing_edges(1)[0].cost == 20.0);
+    BOOST_TEST(g.outgoing_edges(2).size() == 0);
+    BOOST_TEST(g.outgoing_edges(3)[0].destination == 0);
+}
+
+BOOST_AUTO_TEST_CASE(read_metis_test) {
+    // A triangle 1 - 2 - 3 with edge weights and vertex weights and an isolated node 4.
+    std::string path = temporary_file("% comment\n"
+                                      "4 3 011\n"
+                                      "7 2 1.5 3 2\n"
+                                      "8 1 1.5 3 4\n"
+                                      "% comment\n"
+                                      "9 1 2 2 4\n"
+                                      "1\n",
+                                      ".graph");
+    BOOST_TEST((guess_graph_format(path) == graph_format::metis));
+    graph_builder b;
+    BOOST_TEST_REQUIRE(read_metis(path, b, nullptr));
+    const graph g = b.build();
+    boost::filesystem::remove(path);
+
+    BOOST_TEST_REQUIRE(g.node_count() == 4);
+    BOOST_TEST_REQUIRE(g.edge_count() == 6);
+    BOOST_TEST(g.outgoing_edges(0)[0].destination == 1);
+    BOOST_TEST(g.outgoing_edges(0)[0].cost == 1.5);
+    BOOST_TEST(g.outgoing_edges(2)[1].destination == 1);
+    BOOST_TEST(g.outgoing_edges(2)[1].cost == 4.0);
+    BOOST_TEST(g.incoming_edges(3).size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(binary_graph_test) {
+    std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    graph expected;
+    node_map<vec2> expected_positions;
+    std::tie(expected, expected_positions) = make_test_graph_euclidean(1);
+    BOOST_TEST_REQUIRE(write_binary_graph(path, expected, &expected_positions, nullptr));
+    BOOST_TEST(is_binary_graph_file(path));
+
+    node_map<vec2> positions;
+    boost::optional<graph> g = read_binary_graph<size_t, double>(path, &positions, nullptr);
+    // The types have to match the file.
+    bool other_types = read_binary_graph<uint32_t, double>(path, nullptr, nullptr).is_initialized();
+    BOOST_TEST(!other_types);
+    // Without positions, all positions are zero.
+    BOOST_TEST_REQUIRE(write_binary_graph(path, expected, nullptr, nullptr));
+    node_map<vec2> zero_positions;
+    bool loaded = read_binary_graph<size_t, double>(path, &zero_positions, nullptr).is_initialized();
+    BOOST_TEST(loaded);
+    BOOST_TEST((zero_positions == node_map<vec2>(expected.node_count(), vec2(0.0, 0.0))));
+    boost::filesystem::remove(path);
+
+    BOOST_TEST_REQUIRE(g.is_initialized());
+    BOOST_TEST_REQUIRE(g->node_count() == expected.node_count());
+    BOOST_TEST_REQUIRE(g->edge_count() == expected.edge_count());
+    for (size_t node = 0; node < expected.node_count(); ++node) {
+        BOOST_TEST((positions[node] == expected_positions[node]));
+        BOOST_TEST_REQUIRE(g->outgoing_edges(node).size() == expected.outgoing_edges(node).size());
+        for (size_t i = 0; i < expected.outgoing_edges(node).size(); ++i) {
+            BOOST_TEST(g->outgoing_edges(node)[i].destination == expected.outgoing_edges(node)[i].destination);
+            BOOST_TEST(g->outgoing_edges(node)[i].cost == expected.outgoing_edges(node)[i].cost);
+        }
+        BOOST_TEST_REQUIRE(g->incoming_edges(node).size() == expected.incoming_edges(node).size());
+        for (size_t i = 0; i < expected.incoming_edges(node).size(); ++i) {
+            BOOST_TEST(g->incoming_edges(node)[i].source == expected.incoming_edges(node)[i].source);
+            BOOST_TEST(g->incoming_edges(node)[i].index == expected.incoming_edges(node)[i].index);
+        }
+    }
+}
+
+// Writes the graph to a binary graph file, overwrites the bytes at the offset with the value and
+// returns true if the damaged file is rejected as corrupt.
+template <typename T>
+static bool rejects_corruption(const graph& g, const node_map<vec2>& positions, size_t offset, T value) {
+    std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    BOOST_TEST_REQUIRE(write_binary_graph(path, g, &positions, nullptr));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    std::ostringstream err;
+    node_map<vec2> loaded_positions;
+    bool loaded = read_binary_graph<size_t, double>(path, &loaded_positions, &err).is_initialized();
+    boost::filesystem::remove(path);
+    return !loaded && err.str().find("is corrupt!") != std::string::npos;
+}
+
+BOOST_AUTO_TEST_CASE(binary_graph_corrupt_header_test) {
+    graph g;
+    node_map<vec2> positions;
+    std::tie(g, positions) = make_test_graph_euclidean(1);
+
+    // Counts that overflow the layout computation must not pass the size check. With 2^61 more nodes,
+    // the layout wraps around to the one of the original graph.
+    uint64_t wrapped_node_count = (uint64_t(1) << 61) + g.node_count();
+    BOOST_TEST(rejects_corruption(g, positions, offsetof(binary_graph_header, node_count), wrapped_node_count));
+    uint64_t huge_edge_count = (uint64_t(1) << 61) + 2000;
+    BOOST_TEST(rejects_corruption(g, positions, offsetof(binary_graph_header, edge_count), huge_edge_count));
+    BOOST_TEST(rejects_corruption(g, positions, offsetof(binary_graph_header, edge_count), ~uint64_t(0)));
+}
+
+BOOST_AUTO_TEST_CASE(binary_graph_corrupt_arrays_test) {
+    graph g;
+    node_map<vec2> positions;
+    std::tie(g, positions) = make_test_graph_euclidean(1);
+
+    // The arrays follow the header, each one is aligned to 64 bytes.
+    auto aligned = [](size_t bytes) { return (bytes + 63) / 64 * 64; };
+    size_t outgoing_offsets = aligned(sizeof(binary_graph_header));
+    size_t outgoing_destinations = outgoing_offsets + aligned((g.node_count() + 1) * sizeof(uint64_t));
+    size_t outgoing_costs = outgoing_destinations + aligned(g.edge_count() * sizeof(size_t));
+
+    BOOST_TEST(rejects_corruption(g, positions, outgoing_offsets + sizeof(uint64_t), uint64_t(g.edge_count() + 1)));
+    BOOST_TEST(rejects_corruption(g, positions, outgoing_destinations, size_t(g.node_count())));
+    BOOST_TEST(rejects_corruption(g, positions, outgoing_costs, -1.0));
+    BOOST_TEST(rejects_corruption(g, positions, outgoing_costs, std::nan("")));
+}
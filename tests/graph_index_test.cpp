@@ -0,0 +1,57 @@
+#include "graph_index.hpp"
+#include "test_graph.hpp"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace sssp;
+
+BOOST_AUTO_TEST_CASE(graph_index_test) {
+    // 0 --2--> 1 --1--> 2
+    // 0 --5--> 2 --3--> 1
+    graph_builder builder;
+    builder.add_nodes(3);
+    builder.add_edge(0, 1, 2);
+    builder.add_edge(1, 2, 1);
+    builder.add_edge(0, 2, 5);
+    builder.add_edge(2, 1, 3);
+    const graph g = builder.build();
+    const graph_index& index = g.index();
+
+    // The index is built once and shared with copies.
+    const graph copy = g;
+    BOOST_TEST(&copy.index() == &index);
+
+    BOOST_TEST(index.outgoing(0).size() == 2);
+    BOOST_TEST(index.outgoing(0).front().node == 1);
+    BOOST_TEST(index.outgoing(0).front().cost == 2);
+    BOOST_TEST(index.incoming(2).front().node == 1);
+    BOOST_TEST(index.incoming(0).empty());
+
+    BOOST_TEST(index.min_incoming_cost(1) == 2);
+    BOOST_TEST(index.min_outgoing_cost(2) == 3);
+    BOOST_TEST(std::isinf(index.min_incoming_cost(0)));
+
+    // Via 1: 1 + min(2, 3), via 0: infinite because 0 has no incoming edges.
+    graph_index::neighbour_range two_hop = index.two_hop_incoming(2);
+    BOOST_TEST(two_hop.size() == 2);
+    BOOST_TEST(two_hop.front().node == 1);
+    BOOST_TEST(two_hop.front().cost == 3);
+    two_hop.pop_front();
+    BOOST_TEST(std::isinf(two_hop.front().cost));
+}
+
+BOOST_AUTO_TEST_CASE(graph_index_sorted_test) {
+    const graph g = make_test_graph(7);
+    const graph_index& index = g.index();
+    for (size_t node = 0; node < g.node_count(); ++node) {
+        BOOST_TEST_CONTEXT("node = " << node) {
+            BOOST_TEST(index.incoming(node).size() == g.incoming_edges(node).size());
+            BOOST_TEST(index.outgoing(node).size() == g.outgoing_edges(node).size());
+            const bool sorted = std::is_sorted(index.incoming(node).begin(),
+                                               index.incoming(node).end(),
+                                               [](const auto& a, const auto& b) { return a.cost < b.cost; });
+            BOOST_TEST(sorted);
+        }
+    }
+}
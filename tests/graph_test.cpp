@@ -1,20 +1,22 @@
 #include "graph.hpp"
+#include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace sssp;
 namespace tt = boost::test_tools;
 
 BOOST_AUTO_TEST_CASE(graph_test) {
-    graph g;
-    g.add_node();
-    g.add_node();
-    g.add_node();
+    graph_builder b;
+    b.add_node();
+    b.add_node();
+    b.add_node();
+    b.add_edge(0, 1, 1234.5);
+    b.add_edge(0, 2, 1.2345);
+    b.add_edge(1, 2, 1.0);
+    const graph g = b.build();
 
     BOOST_TEST_REQUIRE(g.node_count() == 3);
-
-    g.add_edge(0, 1, 1234.5);
-    g.add_edge(0, 2, 1.2345);
-    g.add_edge(1, 2, 1.0);
+    BOOST_TEST_REQUIRE(g.edge_count() == 3);
 
     BOOST_TEST_REQUIRE(g.incoming_edges(0).size() == 0);
     BOOST_TEST_REQUIRE(g.incoming_edges(1).size() == 1);
@@ -32,11 +34,89 @@ BOOST_AUTO_TEST_CASE(graph_test) {
     BOOST_TEST(g.outgoing_edges(1)[0].destination == 2);
 }
 
+BOOST_AUTO_TEST_CASE(graph_empty_test) {
+    const graph g;
+
+    BOOST_TEST(g.node_count() == 0);
+    BOOST_TEST(g.edge_count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(graph_edge_order_test) {
+    graph_builder b;
+    for (size_t i = 0; i < 4; ++i) {
+        b.add_node();
+    }
+    b.add_edge(0, 3, 1.0);
+    b.add_edge(2, 1, 2.0);
+    b.add_edge(0, 1, 3.0);
+    b.add_edge(3, 1, 4.0);
+    b.add_edge(0, 2, 5.0);
+    const graph g = b.build();
+
+    std::vector<size_t> outgoing;
+    for (const edge_info& edge : g.outgoing_edges(0)) {
+        BOOST_TEST(edge.source == 0);
+        outgoing.push_back(edge.destination);
+    }
+    BOOST_TEST(outgoing == std::vector<size_t>({1, 2, 3}), tt::per_element());
+
+    std::vector<size_t> incoming;
+    for (const edge_info& edge : g.incoming_edges(1)) {
+        BOOST_TEST(edge.destination == 1);
+        incoming.push_back(edge.source);
+    }
+    BOOST_TEST(incoming == std::vector<size_t>({0, 2, 3}), tt::per_element());
+    BOOST_TEST(g.incoming_edges(1).back().cost == 4.0);
+}
+
+BOOST_AUTO_TEST_CASE(graph_builder_dedup_test) {
+    graph_builder b;
+    b.add_nodes(3);
+    b.add_edges({edge_info(0, 1, 3.0), edge_info(1, 2, 1.0), edge_info(0, 1, 2.0), edge_info(2, 2, 1.0)});
+    b.add_edge(0, 1, 5.0);
+    b.add_edge(1, 2, 1.0);
+    const graph g = b.build();
+
+    BOOST_TEST_REQUIRE(g.node_count() == 3);
+    BOOST_TEST_REQUIRE(g.edge_count() == 2);
+    BOOST_TEST_REQUIRE(g.outgoing_edges(0).size() == 1);
+    BOOST_TEST(g.outgoing_edges(0)[0].cost == 2.0);
+    BOOST_TEST_REQUIRE(g.incoming_edges(2).size() == 1);
+    BOOST_TEST(g.incoming_edges(2)[0].source == 1);
+}
+
+BOOST_AUTO_TEST_CASE(graph_builder_large_test) {
+    // Large enough to be sorted by multiple threads.
+    const size_t node_count = 1000;
+    graph_builder b;
+    b.add_nodes(node_count);
+    for (size_t i = 0; i < 200000; ++i) {
+        size_t source = (i * 7919) % node_count;
+        size_t destination = (i * 104729 + 1) % node_count;
+        b.add_edge(source, destination, static_cast<double>(i % 13));
+    }
+    const graph g = b.build();
+
+    size_t incoming_count = 0;
+    for (size_t node = 0; node < g.node_count(); ++node) {
+        const edge_range outgoing = g.outgoing_edges(node);
+        for (size_t i = 0; i < outgoing.size(); ++i) {
+            BOOST_TEST_REQUIRE(outgoing[i].destination != node);
+            if (i > 0) {
+                BOOST_TEST_REQUIRE(outgoing[i - 1].destination < outgoing[i].destination);
+            }
+        }
+        incoming_count += g.incoming_edges(node).size();
+    }
+    BOOST_TEST(incoming_count == g.edge_count());
+}
+
 BOOST_AUTO_TEST_CASE(graph_node_map_test) {
-    graph g;
-    g.add_node();
-    g.add_node();
-    g.add_node();
+    graph_builder b;
+    b.add_node();
+    b.add_node();
+    b.add_node();
+    const graph g = b.build();
 
     node_map<size_t> result = g.make_node_map([](size_t i) { return i; });
 
@@ -47,18 +127,111 @@ BOOST_AUTO_TEST_CASE(graph_node_map_test) {
 }
 
 BOOST_AUTO_TEST_CASE(graph_edge_map_test) {
-    graph g;
-    g.add_node();
-    g.add_node();
-    g.add_node();
-    g.add_edge(0, 1, 1.0);
-    g.add_edge(2, 0, 2.0);
-    g.add_edge(1, 2, 3.0);
+    graph_builder b;
+    b.add_node();
+    b.add_node();
+    b.add_node();
+    b.add_edge(0, 1, 1.0);
+    b.add_edge(2, 0, 2.0);
+    b.add_edge(1, 2, 3.0);
+    b.add_edge(0, 2, 4.0);
+    const graph g = b.build();
 
-    edge_map<size_t> result = g.make_edge_map([](size_t s, size_t d) { return 10 * s + d; });
+    edge_map<size_t> result = g.make_edge_map([](const edge_info& e) { return 10 * e.source + e.destination; });
 
-    BOOST_TEST_REQUIRE(result.size() == 3);
-    BOOST_TEST((result[{0, 1}]) == 1);
-    BOOST_TEST((result[{2, 0}]) == 20);
-    BOOST_TEST((result[{1, 2}]) == 12);
+    BOOST_TEST_REQUIRE(result.size() == 4);
+    BOOST_TEST(result[g.edge_index(0, 0)] == 1);
+    BOOST_TEST(result[g.edge_index(0, 1)] == 2);
+    BOOST_TEST(result[g.edge_index(1, 0)] == 12);
+    BOOST_TEST(result[g.edge_index(2, 0)] == 20);
+}
+
+BOOST_AUTO_TEST_CASE(graph_edge_index_test) {
+    graph_builder b;
+    for (size_t i = 0; i < 4; ++i) {
+        b.add_node();
+    }
+    b.add_edge(3, 0, 1.0);
+    b.add_edge(0, 1, 2.0);
+    b.add_edge(2, 1, 3.0);
+    b.add_edge(0, 3, 4.0);
+    b.add_edge(1, 3, 5.0);
+    const graph g = b.build();
+
+    std::vector<bool> seen(g.edge_count(), false);
+    for (size_t source = 0; source < g.node_count(); ++source) {
+        for (size_t position = 0; position < g.outgoing_edges(source).size(); ++position) {
+            const edge_info edge = g.outgoing_edges(source)[position];
+            BOOST_TEST_REQUIRE(edge.index < g.edge_count());
+            BOOST_TEST(edge.index == g.edge_index(source, position));
+            BOOST_TEST(!seen[edge.index]);
+            seen[edge.index] = true;
+        }
+    }
+
+    // Incoming edges refer to the same index as the outgoing edge.
+    for (size_t destination = 0; destination < g.node_count(); ++destination) {
+        for (const edge_info& incoming : g.incoming_edges(destination)) {
+            bool found = false;
+            for (const edge_info& outgoing : g.outgoing_edges(incoming.source)) {
+                if (outgoing.destination == destination) {
+                    BOOST_TEST(outgoing.index == incoming.index);
+                    BOOST_TEST(outgoing.cost == incoming.cost);
+                    found = true;
+                }
+            }
+            BOOST_TEST(found);
+        }
+    }
+}
+
+using graph_types = boost::mpl::list<basic_graph<size_t, double>,
+                                     basic_graph<size_t, float>,
+                                     basic_graph<uint32_t, double>,
+                                     basic_graph<uint32_t, float>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(graph_compressed_test, Graph, graph_types) {
+    using Node = typename Graph::node_type;
+    using Cost = typename Graph::cost_type;
+
+    // Neighbours before and after each node and far away ones, which need multiple bytes.
+    const size_t node_count = 5000;
+    basic_graph_builder<Node, Cost> b;
+    b.add_nodes(node_count);
+    for (size_t i = 0; i < 50000; ++i) {
+        size_t source = (i * 7919) % node_count;
+        size_t destination = i % 3 == 0 ? (source + i % 5) % node_count : (i * 104729 + 1) % node_count;
+        b.add_edge(static_cast<Node>(source), static_cast<Node>(destination), static_cast<Cost>(i % 13) / 4);
+    }
+    basic_graph_builder<Node, Cost> compressed_builder = b;
+    const Graph expected = b.build();
+    const Graph compressed = compressed_builder.build_compressed();
+    const Graph converted = compress_graph(expected);
+
+    BOOST_TEST(!expected.is_compressed());
+    BOOST_TEST(compressed.is_compressed());
+    BOOST_TEST(converted.is_compressed());
+    BOOST_TEST(compressed.storage_size() < expected.storage_size());
+    for (const Graph* g : {&compressed, &converted}) {
+        BOOST_TEST_REQUIRE(g->node_count() == expected.node_count());
+        BOOST_TEST_REQUIRE(g->edge_count() == expected.edge_count());
+        for (size_t n = 0; n < node_count; ++n) {
+            const Node node = static_cast<Node>(n);
+            for (auto edges : {std::make_pair(g->outgoing_edges(node), expected.outgoing_edges(node)),
+                               std::make_pair(g->incoming_edges(node), expected.incoming_edges(node))}) {
+                BOOST_TEST_REQUIRE(edges.first.size() == edges.second.size());
+                auto expected_edge = edges.second.begin();
+                for (const auto& edge : edges.first) {
+                    BOOST_TEST_REQUIRE(edge.source == expected_edge->source);
+                    BOOST_TEST_REQUIRE(edge.destination == expected_edge->destination);
+                    BOOST_TEST_REQUIRE(edge.cost == expected_edge->cost);
+                    BOOST_TEST_REQUIRE(edge.index == expected_edge->index);
+                    ++expected_edge;
+                }
+                if (!edges.first.empty()) {
+                    BOOST_TEST(edges.first.back().index == edges.second.back().index);
+                }
+            }
+        }
+    }
 }
@@ -0,0 +1,57 @@
+#include "node_set.hpp"
+#include <boost/test/unit_test.hpp>
+
+using namespace sssp;
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE(node_set_test) {
+    basic_node_set<size_t> set(10);
+    BOOST_TEST(set.empty());
+
+    set.emplace(7);
+    set.emplace(2);
+    set.emplace(7);
+    std::vector<size_t> more = {5, 2, 9};
+    set.insert(more.begin(), more.end());
+    BOOST_TEST(set.size() == 4);
+    BOOST_TEST(set.contains(2));
+    BOOST_TEST(!set.contains(3));
+
+    // The insertion order is kept until the set is sorted.
+    std::vector<size_t> inserted(set.begin(), set.end());
+    BOOST_TEST(inserted == std::vector<size_t>({7, 2, 5, 9}), tt::per_element());
+    set.sort();
+    std::vector<size_t> sorted(set.begin(), set.end());
+    BOOST_TEST(sorted == std::vector<size_t>({2, 5, 7, 9}), tt::per_element());
+
+    set.clear();
+    BOOST_TEST(set.empty());
+    BOOST_TEST(!set.contains(7));
+    set.emplace(7);
+    BOOST_TEST(set.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(erasable_node_set_test) {
+    basic_erasable_node_set<uint32_t> set(10);
+    BOOST_TEST(set.empty());
+
+    set.insert(7);
+    set.insert(2);
+    set.insert(7);
+    set.insert(5);
+    BOOST_TEST(set.size() == 3);
+
+    // The last node takes the place of the erased one.
+    set.erase(7);
+    set.erase(3);
+    BOOST_TEST(set.size() == 2);
+    BOOST_TEST(!set.contains(7));
+    std::vector<uint32_t> nodes(set.begin(), set.end());
+    BOOST_TEST(nodes == std::vector<uint32_t>({5, 2}), tt::per_element());
+
+    set.erase(2);
+    set.erase(5);
+    BOOST_TEST(set.empty());
+    set.insert(2);
+    BOOST_TEST(set.contains(2));
+}
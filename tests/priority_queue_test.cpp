@@ -0,0 +1,132 @@
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <set>
+#include <tuple>
+
+using namespace sssp;
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE(priority_queue_test) {
+    priority_queue<double> queue(10);
+    BOOST_TEST(queue.empty());
+
+    queue.push(4, 2.5);
+    queue.push(7, 1.0);
+    queue.push(3, 1.0);
+    queue.push(5, 3.0);
+    queue.push(8, 0.5);
+    BOOST_TEST(queue.size() == 5);
+    BOOST_TEST(queue.top() == 8);
+
+    queue.increase(8, 2.0);
+    // Ties are broken by the item index.
+    BOOST_TEST(queue.top() == 3);
+    queue.decrease(5, 0.25);
+    BOOST_TEST(queue.top() == 5);
+    queue.update(5, 4.0);
+    queue.erase(3);
+    BOOST_TEST(!queue.contains(3));
+    BOOST_TEST(queue.key(8) == 2.0);
+
+    std::vector<size_t> prefix;
+    queue.for_each_up_to(2.5, [&](size_t item) { prefix.push_back(item); });
+    BOOST_TEST(prefix == std::vector<size_t>({7, 8, 4}), tt::per_element());
+    prefix.clear();
+    queue.for_each_unordered_up_to(2.0, [&](size_t item) { prefix.push_back(item); });
+    std::sort(prefix.begin(), prefix.end());
+    BOOST_TEST(prefix == std::vector<size_t>({7, 8}), tt::per_element());
+
+    BOOST_TEST(queue.pop() == 7);
+    queue.clear();
+    BOOST_TEST(queue.empty());
+    BOOST_TEST(!queue.contains(5));
+}
+
+BOOST_AUTO_TEST_CASE(priority_queue_random_test) {
+    std::mt19937 rng(42);
+    const size_t item_count = 100;
+    priority_queue<int, uint32_t, std::less<int>, 3> queue(item_count);
+    std::set<std::tuple<int, uint32_t>> reference;
+    std::vector<int> keys(item_count);
+
+    for (int step = 0; step < 5000; ++step) {
+        uint32_t item = std::uniform_int_distribution<uint32_t>(0, item_count - 1)(rng);
+        int key = std::uniform_int_distribution<int>(0, 50)(rng);
+        if (std::uniform_int_distribution<int>(0, 3)(rng) == 0) {
+            if (queue.contains(item)) {
+                queue.erase(item);
+                reference.erase(std::make_tuple(keys[item], item));
+            }
+        } else if (queue.contains(item)) {
+            queue.update(item, key);
+            reference.erase(std::make_tuple(keys[item], item));
+            reference.emplace(key, item);
+        } else {
+            queue.push(item, key);
+            reference.emplace(key, item);
+        }
+        keys[item] = key;
+
+        BOOST_REQUIRE(queue.size() == reference.size());
+        if (!reference.empty()) {
+            BOOST_REQUIRE(queue.top() == std::get<1>(*reference.begin()));
+        }
+        std::vector<std::tuple<int, uint32_t>> prefix;
+        queue.for_each_up_to(25, [&](uint32_t item) { prefix.emplace_back(queue.key(item), item); });
+        std::vector<std::tuple<int, uint32_t>> expected(reference.begin(),
+                                                        reference.lower_bound(std::make_tuple(26, uint32_t(0))));
+        BOOST_REQUIRE(prefix == expected);
+
+        prefix.clear();
+        queue.for_each_unordered_up_to(25, [&](uint32_t item) { prefix.emplace_back(queue.key(item), item); });
+        std::sort(prefix.begin(), prefix.end());
+        BOOST_REQUIRE(prefix == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_priority_queue_random_test) {
+    std::mt19937 rng(42);
+    const size_t item_count = 100;
+    lazy_priority_queue<int, uint32_t, std::less<int>, 3> queue(item_count);
+    std::set<std::tuple<int, uint32_t>> reference;
+    std::vector<int> keys(item_count);
+    size_t unchanged = 0;
+
+    for (int step = 0; step < 5000; ++step) {
+        uint32_t item = std::uniform_int_distribution<uint32_t>(0, item_count - 1)(rng);
+        // Few distinct keys, so some updates keep the key.
+        int key = std::uniform_int_distribution<int>(0, 5)(rng);
+        if (std::uniform_int_distribution<int>(0, 3)(rng) == 0) {
+            if (queue.contains(item)) {
+                queue.erase(item);
+                reference.erase(std::make_tuple(keys[item], item));
+            }
+        } else if (queue.contains(item)) {
+            unchanged += keys[item] == key;
+            queue.update(item, key);
+            reference.erase(std::make_tuple(keys[item], item));
+            reference.emplace(key, item);
+        } else {
+            queue.push(item, key);
+            reference.emplace(key, item);
+        }
+        keys[item] = key;
+
+        BOOST_REQUIRE(queue.size() == reference.size());
+        if (!reference.empty()) {
+            BOOST_REQUIRE(queue.top() == std::get<1>(*reference.begin()));
+            BOOST_REQUIRE(queue.top_key() == std::get<0>(*reference.begin()));
+        }
+        std::vector<std::tuple<int, uint32_t>> prefix;
+        queue.for_each_unordered_up_to(2, [&](uint32_t item) { prefix.emplace_back(queue.key(item), item); });
+        std::sort(prefix.begin(), prefix.end());
+        std::vector<std::tuple<int, uint32_t>> expected(reference.begin(),
+                                                        reference.lower_bound(std::make_tuple(3, uint32_t(0))));
+        BOOST_REQUIRE(prefix == expected);
+    }
+    BOOST_TEST(queue.counters().unchanged == unchanged);
+    BOOST_TEST(queue.counters().unchanged > 0);
+    BOOST_TEST(queue.counters().stale > 0);
+}
@@ -0,0 +1,56 @@
+#include "graph.hpp"
+#include "radius_stepping.hpp"
+#include "test_graph.hpp"
+#include <boost/test/unit_test.hpp>
+#include <cfloat>
+
+using namespace sssp;
+
+BOOST_AUTO_TEST_CASE(ball_radii_test) {
+    graph_builder b;
+    b.add_nodes(3);
+    b.add_edge(0, 1, 1.0);
+    b.add_edge(1, 2, 2.0);
+    b.add_edge(0, 2, 5.0);
+    const graph g = b.build();
+
+    BOOST_TEST(ball_radii(g, 1, 1) == node_map<double>({1.0, 2.0, INFINITY}));
+    BOOST_TEST(ball_radii(g, 2, 1) == node_map<double>({3.0, INFINITY, INFINITY}));
+    BOOST_TEST(ball_radii(g, 2, 3) == node_map<double>({3.0, INFINITY, INFINITY}));
+}
+
+BOOST_AUTO_TEST_CASE(radius_stepping_distances_test) {
+    for (int seed = 0; seed < 100; ++seed) {
+        BOOST_TEST_CONTEXT("seed = " << seed) {
+            const graph g = make_test_graph(seed);
+            for (size_t rho : {1, 4, 1000}) {
+                BOOST_TEST_CONTEXT("rho = " << rho) {
+                    const node_map<double> radii = ball_radii(g, rho, 1);
+                    BOOST_REQUIRE(ball_radii(g, rho, 3) == radii);
+                    check_label_correcting_distances(g, radius_stepping(g, 0, radii));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(radius_stepping_rerelaxation_test) {
+    const graph g = make_detour_graph();
+
+    // Without radii every step only relaxes the nodes with the smallest distance, like Dijkstra.
+    label_correcting_result settling = radius_stepping(g, 0, node_map<double>(3, 0.0));
+    BOOST_TEST_REQUIRE(settling.phases.size() == 3);
+    for (const label_correcting_phase& phase : settling.phases) {
+        BOOST_TEST(phase.relaxed == 1);
+        BOOST_TEST(phase.rerelaxed == 0);
+    }
+
+    // Infinite radii make a single step of Bellman-Ford, 1 is relaxed with 0.5 first and again with 0.2.
+    label_correcting_result correcting = radius_stepping(g, 0, node_map<double>(3, INFINITY));
+    BOOST_TEST_REQUIRE(correcting.phases.size() == 3);
+    BOOST_TEST(correcting.phases[1].relaxed == 2);
+    BOOST_TEST(correcting.phases[2].relaxed == 1);
+    BOOST_TEST(correcting.phases[2].rerelaxed == 1);
+    BOOST_TEST(correcting.nodes[1].predecessor == 2);
+    BOOST_TEST(correcting.nodes[1].distance == 0.2, boost::test_tools::tolerance(DBL_EPSILON));
+}
@@ -0,0 +1,74 @@
+#include "radix_heap.hpp"
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <set>
+#include <tuple>
+
+using namespace sssp;
+
+BOOST_AUTO_TEST_CASE(radix_heap_test) {
+    radix_heap<size_t, double> heap(10);
+    BOOST_TEST(heap.empty());
+
+    heap.push(4, 2.5);
+    heap.push(7, 1.0);
+    heap.push(3, 1.0);
+    heap.push(5, 0.5);
+    BOOST_TEST(heap.size() == 4);
+    BOOST_TEST(heap.top() == 5);
+
+    heap.erase(5);
+    // Ties are broken by the node index.
+    BOOST_TEST(heap.top() == 3);
+    heap.push(4, 1.0);
+    BOOST_TEST(heap.pop() == 3);
+    BOOST_TEST(heap.pop() == 4);
+    BOOST_TEST(heap.key(7) == 1.0);
+    BOOST_TEST(heap.contains(7));
+    BOOST_TEST(!heap.contains(4));
+
+    // A key below the last minimum redistributes the nodes.
+    heap.push(1, 0.25);
+    BOOST_TEST(heap.pop() == 1);
+    BOOST_TEST(heap.pop() == 7);
+    BOOST_TEST(heap.empty());
+}
+
+BOOST_AUTO_TEST_CASE(radix_heap_random_test) {
+    std::mt19937 rng(42);
+    for (int round = 0; round < 20; ++round) {
+        BOOST_TEST_CONTEXT("round = " << round) {
+            const size_t node_count = 200;
+            radix_heap<uint32_t, float> heap(node_count);
+            std::set<std::tuple<float, uint32_t>> reference;
+            std::vector<float> keys(node_count, -1);
+            float minimum = 0;
+
+            for (int step = 0; step < 2000; ++step) {
+                uint32_t node = std::uniform_int_distribution<uint32_t>(0, node_count - 1)(rng);
+                int operation = std::uniform_int_distribution<int>(0, 9)(rng);
+                if (operation < 6) {
+                    // Mostly keys above the minimum like in Dijkstra's algorithm, rarely below it.
+                    float key = operation == 0 ? std::uniform_real_distribution<float>(0, minimum)(rng)
+                                               : minimum + std::uniform_int_distribution<int>(0, 20)(rng) * 0.125f;
+                    if (keys[node] >= 0) {
+                        reference.erase(std::make_tuple(keys[node], node));
+                    }
+                    keys[node] = key;
+                    reference.emplace(key, node);
+                    heap.push(node, key);
+                } else if (keys[node] >= 0) {
+                    reference.erase(std::make_tuple(keys[node], node));
+                    keys[node] = -1;
+                    heap.erase(node);
+                }
+
+                BOOST_REQUIRE(heap.size() == reference.size());
+                if (!reference.empty()) {
+                    BOOST_REQUIRE(heap.top() == std::get<1>(*reference.begin()));
+                    minimum = std::get<0>(*reference.begin());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "crit_crauser.hpp"
+#include "crit_dijkstra.hpp"
+#include "dijkstra.hpp"
+#include "reorder_nodes.hpp"
+#include "test_graph.hpp"
+#include <boost/test/unit_test.hpp>
+#include <cfloat>
+
+using namespace sssp;
+namespace tt = boost::test_tools;
+
+static bool is_permutation(const node_order& order, size_t node_count) {
+    std::vector<bool> seen(node_count, false);
+    for (size_t node : order) {
+        if (node >= node_count || seen[node]) {
+            return false;
+        }
+        seen[node] = true;
+    }
+    return order.size() == node_count;
+}
+
+BOOST_AUTO_TEST_CASE(hilbert_order_test) {
+    node_map<vec2> positions = {vec2(0.9, 0.1), vec2(0.1, 0.1), vec2(0.9, 0.9), vec2(0.1, 0.9)};
+    node_order order = hilbert_order(positions);
+
+    // The curve starts at 0/0 and ends at 1/0.
+    BOOST_TEST(order == node_order({1, 3, 2, 0}), tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(rcm_order_path_test) {
+    // A path 0 - 3 - 1 - 4 - 2 with a scrambled numbering.
+    graph_builder b;
+    b.add_nodes(5);
+    b.add_edge(0, 3, 1.0);
+    b.add_edge(3, 1, 1.0);
+    b.add_edge(1, 4, 1.0);
+    b.add_edge(4, 2, 1.0);
+    const graph g = b.build();
+
+    node_order order = rcm_order(g);
+    // Cuthill-McKee starts at 0, the node with the smallest degree and index, and is then reversed.
+    BOOST_TEST(order == node_order({2, 4, 1, 3, 0}), tt::per_element());
+
+    const graph reordered = reorder_graph(g, order);
+    for (size_t node = 0; node < reordered.node_count(); ++node) {
+        for (const edge_info& edge : reordered.outgoing_edges(node)) {
+            BOOST_TEST((edge.destination == node + 1 || edge.destination + 1 == node));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reorder_graph_dijkstra_test) {
+    for (int seed = 0; seed < 10; ++seed) {
+        const graph g = make_test_graph(seed);
+
+        boost::base_collection<criteria> criteria;
+        criteria.insert(smallest_tentative_distance(&g, 0));
+        node_map<dijkstra_result> expected = dijkstra(g, 0, criteria);
+
+        for (const node_order& order : {bfs_order(g, 0), rcm_order(g)}) {
+            BOOST_TEST_REQUIRE(is_permutation(order, g.node_count()));
+            const graph reordered = reorder_graph(g, order);
+            BOOST_TEST_REQUIRE(reordered.edge_count() == g.edge_count());
+
+            size_t start_node = inverse_order(order)[0];
+            boost::base_collection<sssp::criteria> reordered_criteria;
+            reordered_criteria.insert(crauser_in(&reordered, start_node, true));
+            reordered_criteria.insert(smallest_tentative_distance(&reordered, start_node));
+            node_map<dijkstra_result> result = dijkstra(reordered, start_node, reordered_criteria);
+
+            for (size_t i = 0; i < order.size(); ++i) {
+                BOOST_TEST(result[i].distance == expected[order[i]].distance, tt::tolerance(DBL_EPSILON));
+            }
+        }
+    }
+}
@@ -1,8 +1,12 @@
 #include "test_graph.hpp"
+#include "dijkstra.hpp"
 #include "generate_edges.hpp"
 #include "generate_positions.hpp"
 #include "graph.hpp"
 #include "math.hpp"
+#include <boost/test/unit_test.hpp>
+#include <cfloat>
+#include <cmath>
 #include <cstdint>
 #include <random>
 
@@ -13,17 +17,17 @@ sssp::graph make_test_graph(int seed) {
     std::uniform_int_distribution<size_t> uniform_node_count(5, 300);
     std::uniform_real_distribution<double> uniform_density(1.0, 5.0);
 
-    sssp::graph g;
+    sssp::graph_builder b;
     size_t node_count = uniform_node_count(rng);
     for (size_t i = 0; i < node_count; ++i) {
-        g.add_node();
+        b.add_node();
     }
     sssp::generate_uniform_edges(uniform_seed(rng),
                                  uniform_density(rng) / node_count,
                                  [&](const auto&) { return uniform_cost(rng); },
-                                 g,
-                                 std::vector<sssp::vec2>(g.node_count()));
-    return g;
+                                 b,
+                                 std::vector<sssp::vec2>(b.node_count()));
+    return b.build();
 }
 
 std::tuple<sssp::graph, sssp::node_map<sssp::vec2>> make_test_graph_euclidean(int seed) {
@@ -34,14 +38,35 @@ std::tuple<sssp::graph, sssp::node_map<sssp::vec2>> make_test_graph_euclidean(in
 
     size_t node_count = uniform_node_count(rng);
     sssp::node_map<sssp::vec2> positions = sssp::generate_uniform_positions(uniform_seed(rng), node_count);
-    sssp::graph g;
+    sssp::graph_builder b;
     for (size_t i = 0; i < node_count; ++i) {
-        g.add_node();
+        b.add_node();
     }
     sssp::generate_uniform_edges(uniform_seed(rng),
                                  uniform_density(rng) / node_count,
                                  [&](const sssp::line& line) { return sssp::distance(line.start, line.end); },
-                                 g,
+                                 b,
                                  positions);
-    return std::make_tuple(std::move(g), std::move(positions));
+    return std::make_tuple(b.build(), std::move(positions));
+}
+
+sssp::graph make_detour_graph() {
+    sssp::graph_builder b;
+    b.add_nodes(3);
+    b.add_edge(0, 1, 0.5);
+    b.add_edge(0, 2, 0.1);
+    b.add_edge(2, 1, 0.1);
+    return b.build();
+}
+
+void check_label_correcting_distances(const sssp::graph& g, const sssp::label_correcting_result& result) {
+    const sssp::node_map<double> reference = sssp::shortest_distances(g, 0);
+    for (size_t node = 0; node < g.node_count(); ++node) {
+        BOOST_TEST_CONTEXT("node = " << node) {
+            const sssp::dijkstra_result& r = result.nodes[node];
+            BOOST_REQUIRE((reference[node] == r.distance || std::abs(reference[node] - r.distance) <= DBL_EPSILON));
+            BOOST_REQUIRE(r.settled() == (reference[node] != INFINITY));
+            BOOST_REQUIRE(r.relaxation_phase < static_cast<int>(result.phases.size()));
+        }
+    }
 }
@@ -1,6 +1,14 @@
 #pragma once
 #include "graph.hpp"
+#include "label_correcting.hpp"
 #include "math.hpp"
 
 sssp::graph make_test_graph(int seed);
 std::tuple<sssp::graph, sssp::node_map<sssp::vec2>> make_test_graph_euclidean(int seed);
+
+// 0 reaches 1 directly with cost 0.5 and cheaper via 2 with cost 0.1 + 0.1.
+sssp::graph make_detour_graph();
+
+// Checks the distances of a label correcting algorithm started at node 0 against Dijkstra's, that
+// exactly the reachable nodes are settled and that each node was relaxed in one of the phases.
+void check_label_correcting_distances(const sssp::graph& g, const sssp::label_correcting_result& result);